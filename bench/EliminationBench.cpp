@@ -0,0 +1,88 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "TConcurrentStack.h"
+#include "TEliminationStack.h"
+
+using namespace std;
+
+template <class Stack>
+double RunSymmetric(Stack& stack, size_t threadsCount, chrono::milliseconds duration, unsigned long long& total)
+{
+  atomic<bool> start(false);
+  atomic<bool> stop(false);
+  vector<unsigned long long> ops(threadsCount, 0);
+  vector<thread> threads;
+
+  for (size_t t = 0; t < threadsCount; ++t)
+    threads.emplace_back([&, t]()
+    {
+      uint32_t seed = (uint32_t)t * 2654435761u + 1;
+      unsigned long long done = 0;
+      int element = 0;
+      while (!start.load(memory_order_acquire))
+        this_thread::yield();
+      while (!stop.load(memory_order_relaxed))
+      {
+        for (int i = 0; i < 64; ++i)
+        {
+          seed ^= seed << 13;
+          seed ^= seed >> 17;
+          seed ^= seed << 5;
+          if (seed & 1)
+            stack.push(element++);
+          else
+            stack.pop(element);
+        }
+        done += 64;
+      }
+      ops[t] = done;
+    });
+
+  auto begin = chrono::steady_clock::now();
+  start.store(true, memory_order_release);
+  this_thread::sleep_for(duration);
+  stop.store(true, memory_order_relaxed);
+  for (auto& t : threads)
+    t.join();
+  double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+  total = 0;
+  for (auto n : ops)
+    total += n;
+  return total / seconds / 1e6;
+}
+
+int main(int argc, char** argv)
+{
+  size_t width = argc > 1 ? strtoul(argv[1], nullptr, 10) : 8;
+  size_t backoff = argc > 2 ? strtoul(argv[2], nullptr, 10) : 128;
+  size_t maxThreads = argc > 3 ? strtoul(argv[3], nullptr, 10) : 64;
+  chrono::milliseconds duration(argc > 4 ? strtoul(argv[4], nullptr, 10) : 200);
+  const size_t capacity = 1 << 16;
+
+  cout << "width=" << width << " backoff=" << backoff << " duration=" << duration.count() << "ms" << endl;
+  cout << setw(8) << "threads" << setw(16) << "treiber Mops/s" << setw(20) << "elimination Mops/s" << setw(14) << "eliminated %" << endl;
+
+  for (size_t threadsCount = 1; threadsCount <= maxThreads; threadsCount *= 2)
+  {
+    TConcurrentStack<int> treiber(capacity);
+    TEliminationStack<int> elimination(capacity, width, backoff);
+    for (int i = 0; i < 1024; ++i)
+    {
+      treiber.push(i);
+      elimination.push(i);
+    }
+
+    unsigned long long treiberOps = 0;
+    unsigned long long eliminationOps = 0;
+    double a = RunSymmetric(treiber, threadsCount, duration, treiberOps);
+    double b = RunSymmetric(elimination, threadsCount, duration, eliminationOps);
+    double eliminated = eliminationOps == 0 ? 0 : 200.0 * elimination.GetEliminations() / eliminationOps;
+    cout << setw(8) << threadsCount << fixed << setprecision(2) << setw(16) << a << setw(20) << b << setw(14) << eliminated << endl;
+  }
+}
@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include "TQueue.h"
+#include "TSPSCQueue.h"
+#include "TMPMCQueue.h"
+
+using namespace std;
+
+struct TMessage
+{
+  uint64_t timestamp;
+  uint64_t sequence;
+};
+
+struct TConfig
+{
+  string queue = "all";
+  size_t producers = 1;
+  size_t consumers = 1;
+  size_t capacity = 1024;
+  size_t messages = 1000000;
+  bool pin = false;
+  bool block = false;
+  string csv;
+  string json;
+};
+
+struct TResult
+{
+  string queue;
+  double seconds;
+  double mops;
+  uint64_t p50;
+  uint64_t p99;
+  uint64_t p999;
+};
+
+static uint64_t Now()
+{
+  return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void Pin(size_t index)
+{
+#ifdef __linux__
+  unsigned cpus = max(1u, thread::hardware_concurrency());
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(index % cpus, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)index;
+#endif
+}
+
+class TMutexQueue
+{
+protected:
+  mutex lock;
+  condition_variable notEmpty;
+  condition_variable notFull;
+  TQueue<TMessage, TModuloIndex, allocator<TMessage>, TNoGrowth> queue;
+public:
+  TMutexQueue(size_t capacity) : queue(capacity) {}
+
+  bool try_enqueue(const TMessage& message)
+  {
+    {
+      lock_guard<mutex> guard(lock);
+      if (queue.IsFull())
+        return false;
+      queue.enqueue(message);
+    }
+    notEmpty.notify_one();
+    return true;
+  }
+
+  bool try_dequeue(TMessage& message)
+  {
+    {
+      lock_guard<mutex> guard(lock);
+      if (queue.IsEmpty())
+        return false;
+      message = queue.dequeue();
+    }
+    notFull.notify_one();
+    return true;
+  }
+
+  void enqueue(const TMessage& message)
+  {
+    {
+      unique_lock<mutex> guard(lock);
+      notFull.wait(guard, [&]() { return !queue.IsFull(); });
+      queue.enqueue(message);
+    }
+    notEmpty.notify_one();
+  }
+
+  template <class Rep, class Period>
+  bool dequeue_for(TMessage& message, const chrono::duration<Rep, Period>& timeout)
+  {
+    {
+      unique_lock<mutex> guard(lock);
+      if (!notEmpty.wait_for(guard, timeout, [&]() { return !queue.IsEmpty(); }))
+        return false;
+      message = queue.dequeue();
+    }
+    notFull.notify_one();
+    return true;
+  }
+};
+
+template <class Queue>
+TResult Run(const string& name, Queue& queue, const TConfig& config)
+{
+  atomic<bool> start(false);
+  atomic<size_t> consumed(0);
+  vector<vector<uint64_t>> latencies(config.consumers);
+  vector<thread> threads;
+  size_t perProducer = config.messages / config.producers;
+  size_t total = perProducer * config.producers;
+
+  for (size_t p = 0; p < config.producers; ++p)
+    threads.emplace_back([&, p]()
+    {
+      if (config.pin)
+        Pin(p);
+      while (!start.load(memory_order_acquire))
+        this_thread::yield();
+      for (size_t i = 0; i < perProducer; ++i)
+      {
+        TMessage message = {Now(), i};
+        if (config.block)
+        {
+          queue.enqueue(message);
+          continue;
+        }
+        while (!queue.try_enqueue(message))
+        {
+          this_thread::yield();
+          message.timestamp = Now();
+        }
+      }
+    });
+
+  for (size_t c = 0; c < config.consumers; ++c)
+    threads.emplace_back([&, c]()
+    {
+      if (config.pin)
+        Pin(config.producers + c);
+      vector<uint64_t>& samples = latencies[c];
+      samples.reserve(total / config.consumers + 1);
+      while (!start.load(memory_order_acquire))
+        this_thread::yield();
+      TMessage message;
+      while (consumed.load(memory_order_relaxed) < total)
+      {
+        if (config.block ? queue.dequeue_for(message, chrono::milliseconds(1)) : queue.try_dequeue(message))
+        {
+          samples.push_back(Now() - message.timestamp);
+          consumed.fetch_add(1, memory_order_relaxed);
+        }
+        else if (!config.block)
+          this_thread::yield();
+      }
+    });
+
+  uint64_t begin = Now();
+  start.store(true, memory_order_release);
+  for (auto& t : threads)
+    t.join();
+  double seconds = (Now() - begin) * 1e-9;
+
+  vector<uint64_t> all;
+  all.reserve(total);
+  for (auto& samples : latencies)
+    all.insert(all.end(), samples.begin(), samples.end());
+  sort(all.begin(), all.end());
+  auto percentile = [&](double q) -> uint64_t
+  {
+    if (all.empty())
+      return 0;
+    return all[min(all.size() - 1, (size_t)(q * all.size()))];
+  };
+
+  return {config.block ? name + "/block" : name, seconds, total / seconds / 1e6, percentile(0.5), percentile(0.99), percentile(0.999)};
+}
+
+static void Report(const TResult& result, const TConfig& config)
+{
+  cout << setw(12) << result.queue << setw(6) << config.producers << setw(6) << config.consumers
+       << fixed << setprecision(2) << setw(12) << result.mops
+       << setw(12) << result.p50 << setw(12) << result.p99 << setw(12) << result.p999 << endl;
+
+  long long stamp = chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+  if (!config.csv.empty())
+  {
+    bool fresh = !ifstream(config.csv).good();
+    ofstream os(config.csv, ios::app);
+    if (fresh)
+      os << "unix_time,queue,producers,consumers,capacity,messages,pinned,seconds,mops,p50_ns,p99_ns,p999_ns\n";
+    os << stamp << "," << result.queue << "," << config.producers << "," << config.consumers << ","
+       << config.capacity << "," << config.messages << "," << config.pin << "," << result.seconds << ","
+       << result.mops << "," << result.p50 << "," << result.p99 << "," << result.p999 << "\n";
+  }
+  if (!config.json.empty())
+  {
+    ofstream os(config.json, ios::app);
+    os << "{\"unix_time\": " << stamp << ", \"queue\": \"" << result.queue << "\", \"producers\": " << config.producers
+       << ", \"consumers\": " << config.consumers << ", \"capacity\": " << config.capacity
+       << ", \"messages\": " << config.messages << ", \"pinned\": " << (config.pin ? "true" : "false")
+       << ", \"seconds\": " << result.seconds << ", \"mops\": " << result.mops << ", \"p50_ns\": " << result.p50
+       << ", \"p99_ns\": " << result.p99 << ", \"p999_ns\": " << result.p999 << "}\n";
+  }
+}
+
+static bool Parse(int argc, char** argv, TConfig& config)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    string arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (arg == "--pin")
+      config.pin = true;
+    else if (arg == "--block")
+      config.block = true;
+    else if (value == nullptr)
+      return false;
+    else if (arg == "--queue")
+      config.queue = argv[++i];
+    else if (arg == "--producers")
+      config.producers = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--consumers")
+      config.consumers = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--capacity")
+      config.capacity = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--messages")
+      config.messages = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--csv")
+      config.csv = argv[++i];
+    else if (arg == "--json")
+      config.json = argv[++i];
+    else
+      return false;
+  }
+  return config.producers > 0 && config.consumers > 0 && config.capacity > 1 && config.messages >= config.producers;
+}
+
+int main(int argc, char** argv)
+{
+  TConfig config;
+  if (!Parse(argc, argv, config))
+  {
+    cerr << "usage: " << argv[0] << " [--queue mutex|spsc|mpmc|all] [--producers N] [--consumers M]"
+         << " [--capacity C] [--messages K] [--pin] [--block] [--csv file] [--json file]" << endl;
+    return 1;
+  }
+
+  cout << setw(12) << "queue" << setw(6) << "prod" << setw(6) << "cons" << setw(12) << "Mmsg/s"
+       << setw(12) << "p50 ns" << setw(12) << "p99 ns" << setw(12) << "p99.9 ns" << endl;
+
+  bool all = config.queue == "all";
+  if (all || config.queue == "mutex")
+  {
+    TMutexQueue queue(config.capacity);
+    Report(Run("mutex", queue, config), config);
+  }
+  if ((all || config.queue == "spsc") && config.producers == 1 && config.consumers == 1)
+  {
+    TSPSCQueue<TMessage> queue(config.capacity);
+    Report(Run("spsc", queue, config), config);
+  }
+  else if (config.queue == "spsc")
+    cerr << "spsc needs exactly one producer and one consumer" << endl;
+  if (all || config.queue == "mpmc")
+  {
+    TMPMCQueue<TMessage> queue(config.capacity);
+    Report(Run("mpmc", queue, config), config);
+  }
+}
@@ -0,0 +1,281 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "TStack.h"
+#include "TQueue.h"
+#include "TSegmentedQueue.h"
+#include "TSegmentedStack.h"
+
+using namespace std;
+
+static atomic<size_t> allocations(0);
+
+static void* Allocate(size_t size, size_t alignment) noexcept
+{
+  allocations.fetch_add(1, memory_order_relaxed);
+  void* p = nullptr;
+  if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    p = malloc(size ? size : 1);
+  else if (posix_memalign(&p, alignment, size ? size : 1) != 0)
+    p = nullptr;
+  return p;
+}
+
+static void* AllocateOrThrow(size_t size, size_t alignment)
+{
+  if (void* p = Allocate(size, alignment))
+    return p;
+  throw bad_alloc();
+}
+
+void* operator new(size_t size) { return AllocateOrThrow(size, 0); }
+void* operator new[](size_t size) { return AllocateOrThrow(size, 0); }
+void* operator new(size_t size, align_val_t alignment) { return AllocateOrThrow(size, (size_t)alignment); }
+void* operator new[](size_t size, align_val_t alignment) { return AllocateOrThrow(size, (size_t)alignment); }
+void* operator new(size_t size, const nothrow_t&) noexcept { return Allocate(size, 0); }
+void* operator new[](size_t size, const nothrow_t&) noexcept { return Allocate(size, 0); }
+void* operator new(size_t size, align_val_t alignment, const nothrow_t&) noexcept { return Allocate(size, (size_t)alignment); }
+void* operator new[](size_t size, align_val_t alignment, const nothrow_t&) noexcept { return Allocate(size, (size_t)alignment); }
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, align_val_t) noexcept { free(p); }
+void operator delete[](void* p, align_val_t) noexcept { free(p); }
+void operator delete(void* p, size_t, align_val_t) noexcept { free(p); }
+void operator delete[](void* p, size_t, align_val_t) noexcept { free(p); }
+void operator delete(void* p, const nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const nothrow_t&) noexcept { free(p); }
+void operator delete(void* p, align_val_t, const nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, align_val_t, const nothrow_t&) noexcept { free(p); }
+
+struct TPod64
+{
+  long long values[8];
+};
+
+template <class T>
+T MakeElement(size_t i);
+
+template <>
+int MakeElement<int>(size_t i)
+{
+  return (int)i;
+}
+
+template <>
+TPod64 MakeElement<TPod64>(size_t i)
+{
+  TPod64 pod = {};
+  pod.values[0] = (long long)i;
+  return pod;
+}
+
+template <>
+string MakeElement<string>(size_t i)
+{
+  return string(32, (char)('a' + i % 26));
+}
+
+template <class T>
+struct TStackOps
+{
+  using Container = TStack<T>;
+
+  static void Put(Container& c, const T& element) { c.push(element); }
+  static T Take(Container& c) { return c.pop(); }
+};
+
+template <class T>
+struct TQueueOps
+{
+  using Container = TQueue<T>;
+
+  static void Put(Container& c, const T& element) { c.enqueue(element); }
+  static T Take(Container& c) { return c.dequeue(); }
+};
+
+template <class T>
+struct TSmallStackOps
+{
+  using Container = TSmallStack<T, 16>;
+
+  static void Put(Container& c, const T& element) { c.push(element); }
+  static T Take(Container& c) { return c.pop(); }
+};
+
+template <class T>
+struct TSmallQueueOps
+{
+  using Container = TSmallQueue<T, 16>;
+
+  static void Put(Container& c, const T& element) { c.enqueue(element); }
+  static T Take(Container& c) { return c.dequeue(); }
+};
+
+template <class T>
+struct TSegmentedStackOps
+{
+  using Container = TSegmentedStack<T>;
+
+  static void Put(Container& c, const T& element) { c.push(element); }
+  static T Take(Container& c) { return c.pop(); }
+};
+
+template <class T>
+struct TSegmentedQueueOps
+{
+  using Container = TSegmentedQueue<T>;
+
+  static void Put(Container& c, const T& element) { c.enqueue(element); }
+  static T Take(Container& c) { return c.dequeue(); }
+};
+
+class TReport
+{
+protected:
+  benchmark::State& state;
+  size_t opsPerIteration;
+  size_t elementSize;
+  size_t startAllocations;
+public:
+  TReport(benchmark::State& state_, size_t opsPerIteration_, size_t elementSize_) : state(state_), opsPerIteration(opsPerIteration_), elementSize(elementSize_), startAllocations(allocations.load()) {}
+
+  ~TReport()
+  {
+    double ops = (double)state.iterations() * opsPerIteration;
+    state.SetItemsProcessed((int64_t)ops);
+    state.SetBytesProcessed((int64_t)(ops * elementSize));
+    state.counters["time/op"] = benchmark::Counter(ops, benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["allocs/op"] = (allocations.load() - startAllocations) / (ops ? ops : 1);
+  }
+};
+
+template <class Ops, class T>
+static void SteadyState(benchmark::State& state)
+{
+  size_t n = state.range(0);
+  typename Ops::Container c(n + 1);
+  for (size_t i = 0; i < n; ++i)
+    Ops::Put(c, MakeElement<T>(i));
+  T element = MakeElement<T>(n);
+
+  TReport report(state, 2, sizeof(T));
+  for (auto _ : state)
+  {
+    Ops::Put(c, element);
+    benchmark::DoNotOptimize(element = Ops::Take(c));
+  }
+}
+
+template <class Ops, class T>
+static void Burst(benchmark::State& state)
+{
+  size_t n = state.range(0);
+  typename Ops::Container c(n);
+  T element = MakeElement<T>(0);
+
+  TReport report(state, 2 * n, sizeof(T));
+  for (auto _ : state)
+  {
+    for (size_t i = 0; i < n; ++i)
+      Ops::Put(c, element);
+    for (size_t i = 0; i < n; ++i)
+      benchmark::DoNotOptimize(Ops::Take(c));
+  }
+}
+
+template <class Ops, class T>
+static void GrowFromZero(benchmark::State& state)
+{
+  size_t n = state.range(0);
+  T element = MakeElement<T>(0);
+
+  TReport report(state, n, sizeof(T));
+  for (auto _ : state)
+  {
+    typename Ops::Container c;
+    for (size_t i = 0; i < n; ++i)
+      Ops::Put(c, element);
+    benchmark::DoNotOptimize(c.Size());
+  }
+}
+
+template <class Ops, class T>
+static void ShortLived(benchmark::State& state)
+{
+  size_t n = state.range(0);
+  T element = MakeElement<T>(0);
+
+  TReport report(state, 2 * n, sizeof(T));
+  for (auto _ : state)
+  {
+    typename Ops::Container c;
+    for (size_t i = 0; i < n; ++i)
+      Ops::Put(c, element);
+    for (size_t i = 0; i < n; ++i)
+      benchmark::DoNotOptimize(Ops::Take(c));
+  }
+}
+
+template <class Ops, class T>
+static void Copy(benchmark::State& state)
+{
+  size_t n = state.range(0);
+  typename Ops::Container c(n);
+  for (size_t i = 0; i < n; ++i)
+    Ops::Put(c, MakeElement<T>(i));
+
+  TReport report(state, n, sizeof(T));
+  for (auto _ : state)
+  {
+    typename Ops::Container copy(c);
+    benchmark::DoNotOptimize(copy.GetMemory());
+  }
+}
+
+template <class Ops, class T>
+static void Iterate(benchmark::State& state)
+{
+  size_t n = state.range(0);
+  typename Ops::Container c(n);
+  for (size_t i = 0; i < n; ++i)
+    Ops::Put(c, MakeElement<T>(i));
+
+  TReport report(state, n, sizeof(T));
+  for (auto _ : state)
+  {
+    for (auto it = c.begin(); it != c.end(); ++it)
+      benchmark::DoNotOptimize(*it);
+  }
+}
+
+#define STACKQUEUE_BENCH(pattern, type, lo, hi) \
+  BENCHMARK_TEMPLATE(pattern, TStackOps<type>, type)->RangeMultiplier(16)->Range(lo, hi); \
+  BENCHMARK_TEMPLATE(pattern, TQueueOps<type>, type)->RangeMultiplier(16)->Range(lo, hi)
+
+#define STACKQUEUE_BENCH_ALL(pattern) \
+  STACKQUEUE_BENCH(pattern, int, 1 << 8, 1 << 24); \
+  STACKQUEUE_BENCH(pattern, TPod64, 1 << 6, 1 << 20); \
+  STACKQUEUE_BENCH(pattern, string, 1 << 6, 1 << 18)
+
+STACKQUEUE_BENCH_ALL(SteadyState);
+STACKQUEUE_BENCH_ALL(Burst);
+STACKQUEUE_BENCH_ALL(GrowFromZero);
+STACKQUEUE_BENCH_ALL(Copy);
+STACKQUEUE_BENCH_ALL(Iterate);
+
+BENCHMARK_TEMPLATE(ShortLived, TStackOps<int>, int)->Arg(8)->Arg(16);
+BENCHMARK_TEMPLATE(ShortLived, TSmallStackOps<int>, int)->Arg(8)->Arg(16);
+BENCHMARK_TEMPLATE(ShortLived, TQueueOps<int>, int)->Arg(8)->Arg(16);
+BENCHMARK_TEMPLATE(ShortLived, TSmallQueueOps<int>, int)->Arg(8)->Arg(16);
+
+BENCHMARK_TEMPLATE(GrowFromZero, TSegmentedStackOps<int>, int)->RangeMultiplier(16)->Range(1 << 8, 1 << 24);
+BENCHMARK_TEMPLATE(GrowFromZero, TSegmentedStackOps<TPod64>, TPod64)->RangeMultiplier(16)->Range(1 << 6, 1 << 20);
+BENCHMARK_TEMPLATE(GrowFromZero, TSegmentedQueueOps<int>, int)->RangeMultiplier(16)->Range(1 << 8, 1 << 24);
+BENCHMARK_TEMPLATE(GrowFromZero, TSegmentedQueueOps<TPod64>, TPod64)->RangeMultiplier(16)->Range(1 << 6, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1 @@
+#include "TBinary.h"
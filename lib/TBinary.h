@@ -0,0 +1,181 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+using namespace std;
+
+struct TBinaryHeader
+{
+  static constexpr uint32_t magic = 0x51535442;
+  static constexpr uint32_t swappedMagic = 0x42545351;
+  static constexpr size_t chunkBytes = 1 << 20;
+  static constexpr uint16_t version = 1;
+  static constexpr uint8_t stackKind = 1;
+  static constexpr uint8_t queueKind = 2;
+
+  uint32_t tag;
+  uint16_t format;
+  uint8_t order;
+  uint8_t kind;
+  uint32_t elementSize;
+  uint32_t reserved;
+  uint64_t count;
+
+  static uint8_t NativeOrder();
+};
+
+template <class T>
+struct TSerializer
+{
+  static constexpr bool bulk = is_trivially_copyable_v<T>;
+  static constexpr size_t minSize = sizeof(T);
+
+  static void Write(ostream& os, const T& element);
+  static T Read(istream& is);
+};
+
+template <>
+struct TSerializer<string>
+{
+  static constexpr bool bulk = false;
+  static constexpr size_t minSize = sizeof(uint64_t);
+
+  static void Write(ostream& os, const string& element);
+  static string Read(istream& is);
+};
+
+template <class T>
+void WriteBinaryHeader(ostream& os, uint8_t kind, size_t count);
+template <class T>
+size_t ReadBinaryHeader(istream& is, uint8_t kind, bool& bounded);
+template <class T>
+size_t ReadBinaryBatch(size_t left, bool bounded);
+template <class T>
+void WriteBinaryRun(ostream& os, const T* elements, size_t n);
+void ReadBinaryBytes(istream& is, void* data, size_t size);
+bool GetBinaryRemaining(istream& is, uint64_t& remaining);
+
+inline uint8_t TBinaryHeader::NativeOrder()
+{
+  return endian::native == endian::little ? 1 : 2;
+}
+
+template <class T>
+inline void TSerializer<T>::Write(ostream& os, const T& element)
+{
+  static_assert(bulk, "TSerializer must be specialized for this element type");
+  os.write(reinterpret_cast<const char*>(&element), sizeof(T));
+}
+
+template <class T>
+inline T TSerializer<T>::Read(istream& is)
+{
+  static_assert(bulk, "TSerializer must be specialized for this element type");
+  T element;
+  ReadBinaryBytes(is, &element, sizeof(T));
+  return element;
+}
+
+inline void TSerializer<string>::Write(ostream& os, const string& element)
+{
+  uint64_t size = element.size();
+  os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  os.write(element.data(), element.size());
+}
+
+inline string TSerializer<string>::Read(istream& is)
+{
+  uint64_t size;
+  ReadBinaryBytes(is, &size, sizeof(size));
+  string element;
+  while (element.size() < size)
+  {
+    size_t done = element.size();
+    size_t step = (size_t)min<uint64_t>(size - done, TBinaryHeader::chunkBytes);
+    element.resize(done + step);
+    ReadBinaryBytes(is, element.data() + done, step);
+  }
+  return element;
+}
+
+template <class T>
+inline void WriteBinaryHeader(ostream& os, uint8_t kind, size_t count)
+{
+  TBinaryHeader header;
+  header.tag = TBinaryHeader::magic;
+  header.format = TBinaryHeader::version;
+  header.order = TBinaryHeader::NativeOrder();
+  header.kind = kind;
+  header.elementSize = TSerializer<T>::bulk ? sizeof(T) : 0;
+  header.reserved = 0;
+  header.count = count;
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+template <class T>
+inline size_t ReadBinaryHeader(istream& is, uint8_t kind, bool& bounded)
+{
+  TBinaryHeader header;
+  ReadBinaryBytes(is, &header, sizeof(header));
+  if (header.tag == TBinaryHeader::swappedMagic || (header.tag == TBinaryHeader::magic && header.order != TBinaryHeader::NativeOrder()))
+    throw("Wrong byte order");
+  if (header.tag != TBinaryHeader::magic || header.kind != kind)
+    throw("Wrong binary header");
+  if (header.format > TBinaryHeader::version)
+    throw("Unsupported binary version");
+  if (header.elementSize != (TSerializer<T>::bulk ? sizeof(T) : 0))
+    throw("Wrong element size");
+  uint64_t remaining;
+  bounded = GetBinaryRemaining(is, remaining);
+  if (bounded && header.count > remaining / TSerializer<T>::minSize)
+    throw("Wrong element count");
+  if (header.count > SIZE_MAX / TSerializer<T>::minSize)
+    throw("Wrong element count");
+  return header.count;
+}
+
+template <class T>
+inline size_t ReadBinaryBatch(size_t left, bool bounded)
+{
+  if (bounded)
+    return left;
+  return min(left, max<size_t>(1, TBinaryHeader::chunkBytes / TSerializer<T>::minSize));
+}
+
+template <class T>
+inline void WriteBinaryRun(ostream& os, const T* elements, size_t n)
+{
+  if constexpr (TSerializer<T>::bulk)
+    os.write(reinterpret_cast<const char*>(elements), n * sizeof(T));
+  else
+  {
+    for (size_t i = 0; i < n; ++i)
+      TSerializer<T>::Write(os, elements[i]);
+  }
+}
+
+inline void ReadBinaryBytes(istream& is, void* data, size_t size)
+{
+  if (!is.read(static_cast<char*>(data), size))
+    throw("Binary read error");
+}
+
+inline bool GetBinaryRemaining(istream& is, uint64_t& remaining)
+{
+  streampos pos = is.tellg();
+  if (pos == streampos(-1))
+    return false;
+  if (!is.seekg(0, ios::end))
+  {
+    is.clear();
+    return false;
+  }
+  remaining = (uint64_t)(is.tellg() - pos);
+  is.seekg(pos);
+  return true;
+}
@@ -0,0 +1 @@
+#include "TConcurrentStack.h"
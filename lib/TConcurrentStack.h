@@ -0,0 +1,162 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+template <class T>
+class TConcurrentStack
+{
+protected:
+  static constexpr size_t cacheLine = 64;
+  static constexpr uint32_t nil = UINT32_MAX;
+
+  struct TNode
+  {
+    atomic<uint32_t> next;
+    T data;
+  };
+
+  size_t capacity;
+  TNode* memory;
+
+  alignas(cacheLine) atomic<uint64_t> top;
+  alignas(cacheLine) atomic<uint64_t> freeList;
+
+  static uint64_t Pack(uint32_t index, uint32_t tag);
+  static uint32_t Index(uint64_t word);
+  static uint32_t Tag(uint64_t word);
+
+  uint32_t PopNode(atomic<uint64_t>& list);
+  void PushNode(atomic<uint64_t>& list, uint32_t index);
+  bool TryPopNode(atomic<uint64_t>& list, uint32_t& index);
+  bool TryPushNode(atomic<uint64_t>& list, uint32_t index);
+public:
+  TConcurrentStack(size_t capacity_);
+  TConcurrentStack(const TConcurrentStack& other) = delete;
+  TConcurrentStack& operator=(const TConcurrentStack& other) = delete;
+  ~TConcurrentStack();
+
+  size_t GetCapacity() const;
+
+  bool push(const T& element);
+  bool pop(T& element);
+
+  bool IsEmpty() const;
+};
+
+template <class T>
+inline uint64_t TConcurrentStack<T>::Pack(uint32_t index, uint32_t tag)
+{
+  return ((uint64_t)tag << 32) | index;
+}
+
+template <class T>
+inline uint32_t TConcurrentStack<T>::Index(uint64_t word)
+{
+  return (uint32_t)word;
+}
+
+template <class T>
+inline uint32_t TConcurrentStack<T>::Tag(uint64_t word)
+{
+  return (uint32_t)(word >> 32);
+}
+
+template <class T>
+inline uint32_t TConcurrentStack<T>::PopNode(atomic<uint64_t>& list)
+{
+  uint64_t old = list.load(memory_order_acquire);
+  while (Index(old) != nil)
+  {
+    uint32_t next = memory[Index(old)].next.load(memory_order_relaxed);
+    if (list.compare_exchange_weak(old, Pack(next, Tag(old) + 1), memory_order_acquire, memory_order_acquire))
+      return Index(old);
+  }
+  return nil;
+}
+
+template <class T>
+inline void TConcurrentStack<T>::PushNode(atomic<uint64_t>& list, uint32_t index)
+{
+  uint64_t old = list.load(memory_order_relaxed);
+  do
+  {
+    memory[index].next.store(Index(old), memory_order_relaxed);
+  } while (!list.compare_exchange_weak(old, Pack(index, Tag(old) + 1), memory_order_release, memory_order_relaxed));
+}
+
+template <class T>
+inline bool TConcurrentStack<T>::TryPopNode(atomic<uint64_t>& list, uint32_t& index)
+{
+  uint64_t old = list.load(memory_order_acquire);
+  index = Index(old);
+  if (index == nil)
+    return true;
+
+  uint32_t next = memory[index].next.load(memory_order_relaxed);
+  return list.compare_exchange_strong(old, Pack(next, Tag(old) + 1), memory_order_acquire, memory_order_relaxed);
+}
+
+template <class T>
+inline bool TConcurrentStack<T>::TryPushNode(atomic<uint64_t>& list, uint32_t index)
+{
+  uint64_t old = list.load(memory_order_relaxed);
+  memory[index].next.store(Index(old), memory_order_relaxed);
+  return list.compare_exchange_strong(old, Pack(index, Tag(old) + 1), memory_order_release, memory_order_relaxed);
+}
+
+template <class T>
+inline TConcurrentStack<T>::TConcurrentStack(size_t capacity_) : capacity(capacity_), memory(nullptr), top(Pack(nil, 0)), freeList(Pack(nil, 0))
+{
+  if (capacity_ == 0 || capacity_ >= nil)
+    throw("Wrong capacity");
+
+  memory = new TNode[capacity];
+  for (size_t i = 0; i < capacity; ++i)
+    memory[i].next.store(i + 1 < capacity ? (uint32_t)(i + 1) : nil, memory_order_relaxed);
+  freeList.store(Pack(0, 0), memory_order_relaxed);
+}
+
+template <class T>
+inline TConcurrentStack<T>::~TConcurrentStack()
+{
+  delete[] memory;
+}
+
+template <class T>
+inline size_t TConcurrentStack<T>::GetCapacity() const
+{
+  return capacity;
+}
+
+template <class T>
+inline bool TConcurrentStack<T>::push(const T& element)
+{
+  uint32_t index = PopNode(freeList);
+  if (index == nil)
+    return false;
+
+  memory[index].data = element;
+  PushNode(top, index);
+  return true;
+}
+
+template <class T>
+inline bool TConcurrentStack<T>::pop(T& element)
+{
+  uint32_t index = PopNode(top);
+  if (index == nil)
+    return false;
+
+  element = std::move(memory[index].data);
+  PushNode(freeList, index);
+  return true;
+}
+
+template <class T>
+inline bool TConcurrentStack<T>::IsEmpty() const
+{
+  return Index(top.load(memory_order_acquire)) == nil;
+}
@@ -0,0 +1 @@
+#include "TEliminationStack.h"
@@ -0,0 +1,243 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "TConcurrentStack.h"
+
+using namespace std;
+
+template <class T>
+class TEliminationStack : private TConcurrentStack<T>
+{
+protected:
+  using TConcurrentStack<T>::nil;
+  using TConcurrentStack<T>::memory;
+  using TConcurrentStack<T>::top;
+  using TConcurrentStack<T>::freeList;
+
+  static constexpr uint64_t emptySlot = 0;
+  static constexpr uint64_t offered = 1ull << 32;
+  static constexpr uint64_t taken = 2ull << 32;
+  static constexpr uint64_t done = 3ull << 32;
+  static constexpr uint64_t spare = 4ull << 32;
+  static constexpr uint64_t kindMask = ~0xFFFFFFFFull;
+
+  struct alignas(TConcurrentStack<T>::cacheLine) TSlot
+  {
+    atomic<uint64_t> state;
+    atomic<uint64_t> exchanges;
+  };
+
+  size_t width;
+  size_t backoff;
+  TSlot* slots;
+
+  static void Relax();
+  TSlot& RandomSlot();
+  bool TakeSpare(TSlot& slot, uint32_t& index);
+  uint32_t AcquireNode();
+  bool OfferNode(TSlot& slot, uint32_t index);
+  bool SettleNode(TSlot& slot, uint32_t index);
+  bool EliminatePush(uint32_t index);
+  bool EliminatePop(T& element, size_t spins);
+public:
+  TEliminationStack(size_t capacity_, size_t width_ = 8, size_t backoff_ = 128);
+  ~TEliminationStack();
+
+  using TConcurrentStack<T>::GetCapacity;
+  size_t GetWidth() const;
+  size_t GetBackoff() const;
+  size_t GetEliminations() const;
+  void SetBackoff(size_t backoff_);
+
+  bool push(const T& element);
+  bool pop(T& element);
+
+  using TConcurrentStack<T>::IsEmpty;
+};
+
+template <class T>
+inline void TEliminationStack<T>::Relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+template <class T>
+inline typename TEliminationStack<T>::TSlot& TEliminationStack<T>::RandomSlot()
+{
+  thread_local uint32_t seed = (uint32_t)(uintptr_t)&seed | 1;
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return slots[seed % width];
+}
+
+template <class T>
+inline bool TEliminationStack<T>::TakeSpare(TSlot& slot, uint32_t& index)
+{
+  uint64_t state = slot.state.load(memory_order_relaxed);
+  if ((state & kindMask) != spare || !slot.state.compare_exchange_strong(state, emptySlot, memory_order_acquire, memory_order_relaxed))
+    return false;
+  index = this->Index(state);
+  return true;
+}
+
+template <class T>
+inline uint32_t TEliminationStack<T>::AcquireNode()
+{
+  uint32_t index;
+  if (TakeSpare(RandomSlot(), index))
+    return index;
+  index = this->PopNode(freeList);
+  for (size_t i = 0; i < width && index == nil; ++i)
+    TakeSpare(slots[i], index);
+  return index;
+}
+
+template <class T>
+inline bool TEliminationStack<T>::OfferNode(TSlot& slot, uint32_t index)
+{
+  uint64_t expected = emptySlot;
+  return slot.state.compare_exchange_strong(expected, offered | index, memory_order_release, memory_order_relaxed);
+}
+
+template <class T>
+inline bool TEliminationStack<T>::SettleNode(TSlot& slot, uint32_t index)
+{
+  uint64_t expected = offered | index;
+  if (slot.state.compare_exchange_strong(expected, emptySlot, memory_order_relaxed))
+    return false;
+
+  while (slot.state.load(memory_order_acquire) != (done | index))
+    Relax();
+  slot.exchanges.store(slot.exchanges.load(memory_order_relaxed) + 1, memory_order_relaxed);
+  slot.state.store(spare | index, memory_order_release);
+  return true;
+}
+
+template <class T>
+inline bool TEliminationStack<T>::EliminatePush(uint32_t index)
+{
+  TSlot& slot = RandomSlot();
+  if (!OfferNode(slot, index))
+    return false;
+
+  for (size_t i = 0; i < backoff; ++i)
+  {
+    if (slot.state.load(memory_order_relaxed) != (offered | index))
+      break;
+    Relax();
+  }
+  return SettleNode(slot, index);
+}
+
+template <class T>
+inline bool TEliminationStack<T>::EliminatePop(T& element, size_t spins)
+{
+  TSlot& slot = RandomSlot();
+  for (size_t i = 0; i < spins; ++i)
+  {
+    uint64_t state = slot.state.load(memory_order_relaxed);
+    if ((state & kindMask) == offered)
+    {
+      uint32_t index = this->Index(state);
+      if (slot.state.compare_exchange_strong(state, taken | index, memory_order_acquire, memory_order_relaxed))
+      {
+        element = std::move(memory[index].data);
+        slot.state.store(done | index, memory_order_release);
+        return true;
+      }
+    }
+    Relax();
+  }
+  return false;
+}
+
+template <class T>
+inline TEliminationStack<T>::TEliminationStack(size_t capacity_, size_t width_, size_t backoff_) : TConcurrentStack<T>(capacity_), width(width_), backoff(backoff_), slots(nullptr)
+{
+  if (width_ == 0)
+    throw("Wrong width");
+
+  slots = new TSlot[width];
+  for (size_t i = 0; i < width; ++i)
+  {
+    slots[i].state.store(emptySlot, memory_order_relaxed);
+    slots[i].exchanges.store(0, memory_order_relaxed);
+  }
+}
+
+template <class T>
+inline TEliminationStack<T>::~TEliminationStack()
+{
+  delete[] slots;
+}
+
+template <class T>
+inline size_t TEliminationStack<T>::GetWidth() const
+{
+  return width;
+}
+
+template <class T>
+inline size_t TEliminationStack<T>::GetBackoff() const
+{
+  return backoff;
+}
+
+template <class T>
+inline size_t TEliminationStack<T>::GetEliminations() const
+{
+  size_t count = 0;
+  for (size_t i = 0; i < width; ++i)
+    count += slots[i].exchanges.load(memory_order_relaxed);
+  return count;
+}
+
+template <class T>
+inline void TEliminationStack<T>::SetBackoff(size_t backoff_)
+{
+  backoff = backoff_;
+}
+
+template <class T>
+inline bool TEliminationStack<T>::push(const T& element)
+{
+  uint32_t index = AcquireNode();
+  if (index == nil)
+    return false;
+
+  memory[index].data = element;
+  while (true)
+  {
+    if (this->TryPushNode(top, index))
+      return true;
+    if (EliminatePush(index))
+      return true;
+  }
+}
+
+template <class T>
+inline bool TEliminationStack<T>::pop(T& element)
+{
+  uint32_t index;
+  while (true)
+  {
+    if (this->TryPopNode(top, index))
+    {
+      if (index != nil)
+        break;
+      return EliminatePop(element, 1);
+    }
+    if (EliminatePop(element, backoff))
+      return true;
+  }
+
+  element = std::move(memory[index].data);
+  this->PushNode(freeList, index);
+  return true;
+}
@@ -0,0 +1 @@
+#include "TEventCount.h"
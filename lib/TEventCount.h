@@ -0,0 +1,187 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#if defined(__linux__)
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+class TEventCount
+{
+protected:
+  static constexpr size_t spinCount = 128;
+
+  atomic<uint32_t> epoch;
+  atomic<uint32_t> waiters;
+
+  static void Relax();
+  bool Park(uint32_t key, const chrono::steady_clock::time_point* deadline);
+  void Wake(bool all);
+public:
+  TEventCount();
+  TEventCount(const TEventCount& other) = delete;
+  TEventCount& operator=(const TEventCount& other) = delete;
+
+  uint32_t PrepareWait();
+  void CancelWait();
+  void Wait(uint32_t key);
+  bool WaitUntil(uint32_t key, chrono::steady_clock::time_point deadline);
+
+  void NotifyOne();
+  void NotifyAll();
+
+  template <class Ready>
+  void Await(Ready ready);
+  template <class Ready>
+  bool AwaitUntil(Ready ready, chrono::steady_clock::time_point deadline);
+};
+
+inline TEventCount::TEventCount() : epoch(0), waiters(0) {}
+
+inline void TEventCount::Relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+inline bool TEventCount::Park(uint32_t key, const chrono::steady_clock::time_point* deadline)
+{
+#if defined(__linux__)
+  timespec timeout;
+  timespec* limit = nullptr;
+  if (deadline != nullptr)
+  {
+    auto left = *deadline - chrono::steady_clock::now();
+    if (left <= chrono::steady_clock::duration::zero())
+      return false;
+    auto ns = chrono::duration_cast<chrono::nanoseconds>(left).count();
+    timeout.tv_sec = ns / 1000000000;
+    timeout.tv_nsec = ns % 1000000000;
+    limit = &timeout;
+  }
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAIT_PRIVATE, key, limit, nullptr, 0);
+#else
+  if (deadline == nullptr)
+    epoch.wait(key, memory_order_acquire);
+  else
+  {
+    if (chrono::steady_clock::now() >= *deadline)
+      return false;
+    this_thread::sleep_for(chrono::microseconds(50));
+  }
+#endif
+  return true;
+}
+
+inline void TEventCount::Wake(bool all)
+{
+  atomic_thread_fence(memory_order_seq_cst);
+  if (waiters.load(memory_order_relaxed) == 0)
+    return;
+  epoch.fetch_add(1, memory_order_release);
+#if defined(__linux__)
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch), FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, nullptr, nullptr, 0);
+#else
+  if (all)
+    epoch.notify_all();
+  else
+    epoch.notify_one();
+#endif
+}
+
+inline uint32_t TEventCount::PrepareWait()
+{
+  waiters.fetch_add(1, memory_order_seq_cst);
+  return epoch.load(memory_order_seq_cst);
+}
+
+inline void TEventCount::CancelWait()
+{
+  waiters.fetch_sub(1, memory_order_relaxed);
+}
+
+inline void TEventCount::Wait(uint32_t key)
+{
+  while (epoch.load(memory_order_acquire) == key)
+    Park(key, nullptr);
+  waiters.fetch_sub(1, memory_order_relaxed);
+}
+
+inline bool TEventCount::WaitUntil(uint32_t key, chrono::steady_clock::time_point deadline)
+{
+  bool woken = true;
+  while (epoch.load(memory_order_acquire) == key)
+  {
+    if (!Park(key, &deadline))
+    {
+      woken = false;
+      break;
+    }
+  }
+  waiters.fetch_sub(1, memory_order_relaxed);
+  return woken;
+}
+
+inline void TEventCount::NotifyOne()
+{
+  Wake(false);
+}
+
+inline void TEventCount::NotifyAll()
+{
+  Wake(true);
+}
+
+template <class Ready>
+inline void TEventCount::Await(Ready ready)
+{
+  for (size_t i = 0; i < spinCount; ++i)
+  {
+    if (ready())
+      return;
+    Relax();
+  }
+  while (!ready())
+  {
+    uint32_t key = PrepareWait();
+    if (ready())
+    {
+      CancelWait();
+      return;
+    }
+    Wait(key);
+  }
+}
+
+template <class Ready>
+inline bool TEventCount::AwaitUntil(Ready ready, chrono::steady_clock::time_point deadline)
+{
+  for (size_t i = 0; i < spinCount; ++i)
+  {
+    if (ready())
+      return true;
+    Relax();
+  }
+  while (!ready())
+  {
+    uint32_t key = PrepareWait();
+    if (ready())
+    {
+      CancelWait();
+      return true;
+    }
+    if (!WaitUntil(key, deadline))
+      return ready();
+  }
+  return true;
+}
@@ -0,0 +1 @@
+#include "TGrowth.h"
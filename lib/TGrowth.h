@@ -0,0 +1,106 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+struct TGeometricGrowth
+{
+  size_t initial;
+  double factor;
+
+  TGeometricGrowth(size_t initial_ = 10, double factor_ = 2.0);
+
+  size_t Next(size_t capacity, size_t required) const;
+  size_t Limit() const;
+};
+
+struct TFixedGrowth
+{
+  size_t step;
+
+  TFixedGrowth(size_t step_ = 10);
+
+  size_t Next(size_t capacity, size_t required) const;
+  size_t Limit() const;
+};
+
+struct TCappedGrowth
+{
+  TGeometricGrowth geometric;
+  size_t maximum;
+
+  TCappedGrowth(size_t maximum_ = SIZE_MAX, size_t initial_ = 10, double factor_ = 2.0);
+
+  size_t Next(size_t capacity, size_t required) const;
+  size_t Limit() const;
+};
+
+struct TNoGrowth
+{
+  size_t Next(size_t capacity, size_t required) const;
+  size_t Limit() const;
+};
+
+inline TGeometricGrowth::TGeometricGrowth(size_t initial_, double factor_) : initial(initial_), factor(factor_)
+{
+  if (factor_ < 1.0)
+    throw("Wrong factor");
+}
+
+inline size_t TGeometricGrowth::Next(size_t capacity, size_t required) const
+{
+  if (capacity == 0)
+    return max(initial, required);
+
+  double grown = capacity * factor;
+  if (grown >= (double)SIZE_MAX)
+    return max(required, (size_t)SIZE_MAX / 2);
+  return max(required, (size_t)grown);
+}
+
+inline size_t TGeometricGrowth::Limit() const
+{
+  return SIZE_MAX;
+}
+
+inline TFixedGrowth::TFixedGrowth(size_t step_) : step(step_)
+{
+  if (step_ == 0)
+    throw("Wrong step");
+}
+
+inline size_t TFixedGrowth::Next(size_t capacity, size_t required) const
+{
+  return max(required, capacity + step);
+}
+
+inline size_t TFixedGrowth::Limit() const
+{
+  return SIZE_MAX;
+}
+
+inline TCappedGrowth::TCappedGrowth(size_t maximum_, size_t initial_, double factor_) : geometric(initial_, factor_), maximum(maximum_) {}
+
+inline size_t TCappedGrowth::Next(size_t capacity, size_t required) const
+{
+  if (required > maximum)
+    return 0;
+  return min(maximum, geometric.Next(capacity, required));
+}
+
+inline size_t TCappedGrowth::Limit() const
+{
+  return maximum;
+}
+
+inline size_t TNoGrowth::Next(size_t, size_t) const
+{
+  return 0;
+}
+
+inline size_t TNoGrowth::Limit() const
+{
+  return SIZE_MAX;
+}
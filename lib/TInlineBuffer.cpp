@@ -0,0 +1 @@
+#include "TInlineBuffer.h"
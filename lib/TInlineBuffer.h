@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+
+using namespace std;
+
+template <class T, size_t N>
+struct TInlineBuffer
+{
+  alignas(T) unsigned char storage[N * sizeof(T)];
+
+  T* Data();
+};
+
+template <class T>
+struct TInlineBuffer<T, 0>
+{
+  T* Data();
+};
+
+template <class T, size_t N>
+inline T* TInlineBuffer<T, N>::Data()
+{
+  return reinterpret_cast<T*>(storage);
+}
+
+template <class T>
+inline T* TInlineBuffer<T, 0>::Data()
+{
+  return nullptr;
+}
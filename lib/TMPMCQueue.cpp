@@ -0,0 +1 @@
+#include "TMPMCQueue.h"
@@ -0,0 +1,177 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include "TEventCount.h"
+
+using namespace std;
+
+template <class T>
+class TMPMCQueue
+{
+protected:
+  static constexpr size_t cacheLine = 64;
+
+  struct TCell
+  {
+    atomic<size_t> sequence;
+    T data;
+  };
+
+  size_t capacity;
+  size_t mask;
+  TCell* memory;
+
+  alignas(cacheLine) atomic<size_t> head;
+  alignas(cacheLine) atomic<size_t> tail;
+
+  alignas(cacheLine) TEventCount notEmpty;
+  alignas(cacheLine) TEventCount notFull;
+public:
+  TMPMCQueue(size_t capacity_);
+  TMPMCQueue(const TMPMCQueue& other) = delete;
+  TMPMCQueue& operator=(const TMPMCQueue& other) = delete;
+  ~TMPMCQueue();
+
+  size_t GetCapacity() const;
+
+  size_t Size() const;
+  bool try_enqueue(const T& element);
+  bool try_dequeue(T& element);
+  void enqueue(const T& element);
+  T dequeue();
+  template <class Rep, class Period>
+  bool enqueue_for(const T& element, const chrono::duration<Rep, Period>& timeout);
+  template <class Rep, class Period>
+  bool dequeue_for(T& element, const chrono::duration<Rep, Period>& timeout);
+
+  bool IsEmpty() const;
+  bool IsFull() const;
+};
+
+template <class T>
+inline TMPMCQueue<T>::TMPMCQueue(size_t capacity_) : capacity(bit_ceil(capacity_)), mask(capacity - 1), memory(nullptr), head(0), tail(0)
+{
+  if (capacity_ < 2)
+    throw("Wrong capacity");
+  memory = new TCell[capacity];
+  for (size_t i = 0; i < capacity; ++i)
+    memory[i].sequence.store(i, memory_order_relaxed);
+}
+
+template <class T>
+inline TMPMCQueue<T>::~TMPMCQueue()
+{
+  delete[] memory;
+}
+
+template <class T>
+inline size_t TMPMCQueue<T>::GetCapacity() const
+{
+  return capacity;
+}
+
+template <class T>
+inline size_t TMPMCQueue<T>::Size() const
+{
+  size_t h = head.load(memory_order_acquire);
+  size_t t = tail.load(memory_order_acquire);
+  return t > h ? t - h : 0;
+}
+
+template <class T>
+inline bool TMPMCQueue<T>::try_enqueue(const T& element)
+{
+  size_t pos = tail.load(memory_order_relaxed);
+  TCell* cell;
+  while (true)
+  {
+    cell = &memory[pos & mask];
+    size_t seq = cell->sequence.load(memory_order_acquire);
+    ptrdiff_t diff = (ptrdiff_t)seq - (ptrdiff_t)pos;
+    if (diff == 0)
+    {
+      if (tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+        break;
+    }
+    else if (diff < 0)
+      return false;
+    else
+      pos = tail.load(memory_order_relaxed);
+  }
+
+  cell->data = element;
+  cell->sequence.store(pos + 1, memory_order_release);
+  notEmpty.NotifyOne();
+  return true;
+}
+
+template <class T>
+inline bool TMPMCQueue<T>::try_dequeue(T& element)
+{
+  size_t pos = head.load(memory_order_relaxed);
+  TCell* cell;
+  while (true)
+  {
+    cell = &memory[pos & mask];
+    size_t seq = cell->sequence.load(memory_order_acquire);
+    ptrdiff_t diff = (ptrdiff_t)seq - (ptrdiff_t)(pos + 1);
+    if (diff == 0)
+    {
+      if (head.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+        break;
+    }
+    else if (diff < 0)
+      return false;
+    else
+      pos = head.load(memory_order_relaxed);
+  }
+
+  element = std::move(cell->data);
+  cell->sequence.store(pos + capacity, memory_order_release);
+  notFull.NotifyOne();
+  return true;
+}
+
+template <class T>
+inline void TMPMCQueue<T>::enqueue(const T& element)
+{
+  notFull.Await([&]() { return try_enqueue(element); });
+}
+
+template <class T>
+inline T TMPMCQueue<T>::dequeue()
+{
+  T element;
+  notEmpty.Await([&]() { return try_dequeue(element); });
+  return element;
+}
+
+template <class T>
+template <class Rep, class Period>
+inline bool TMPMCQueue<T>::enqueue_for(const T& element, const chrono::duration<Rep, Period>& timeout)
+{
+  auto deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(timeout);
+  return notFull.AwaitUntil([&]() { return try_enqueue(element); }, deadline);
+}
+
+template <class T>
+template <class Rep, class Period>
+inline bool TMPMCQueue<T>::dequeue_for(T& element, const chrono::duration<Rep, Period>& timeout)
+{
+  auto deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(timeout);
+  return notEmpty.AwaitUntil([&]() { return try_dequeue(element); }, deadline);
+}
+
+template <class T>
+inline bool TMPMCQueue<T>::IsEmpty() const
+{
+  return Size() == 0;
+}
+
+template <class T>
+inline bool TMPMCQueue<T>::IsFull() const
+{
+  return Size() >= capacity;
+}
@@ -0,0 +1 @@
+#include "TMappedQueue.h"
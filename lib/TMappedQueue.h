@@ -0,0 +1,346 @@
+#pragma once
+#if __has_include(<sys/mman.h>)
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "TGrowth.h"
+
+using namespace std;
+
+template <class T, class Growth = TGeometricGrowth>
+class TMappedQueue
+{
+  static_assert(is_trivially_copyable_v<T>, "TMappedQueue requires a trivially copyable element type");
+  static_assert(atomic_ref<uint64_t>::required_alignment <= alignof(uint64_t));
+protected:
+  static constexpr uint32_t magic = 0x334d5354;
+  static constexpr size_t headerSize = 64;
+  static_assert(alignof(T) <= headerSize);
+
+  struct TLayout
+  {
+    uint64_t capacity;
+    uint64_t head;
+    uint64_t tail;
+  };
+
+  struct THeader
+  {
+    uint32_t tag;
+    uint32_t elementSize;
+    uint64_t active;
+    TLayout layouts[2];
+  };
+  static_assert(sizeof(THeader) <= headerSize);
+
+  [[no_unique_address]] Growth growth;
+  int fd;
+  size_t mapped;
+  char* base;
+
+  THeader* Header() const;
+  TLayout& Layout() const;
+  T* Memory() const;
+  static size_t FileSize(size_t capacity_);
+  static uint64_t Load(const uint64_t& word);
+  static void Store(uint64_t& word, uint64_t value);
+  static T Read(const T* slot);
+  void Map(size_t size);
+  void Unmap();
+  void Resize(size_t capacity_);
+public:
+  TMappedQueue(const string& path, size_t capacity_ = 0);
+  TMappedQueue(const TMappedQueue& other) = delete;
+  TMappedQueue& operator=(const TMappedQueue& other) = delete;
+  ~TMappedQueue();
+
+  Growth GetGrowth() const;
+  size_t GetCapacity() const;
+  size_t GetFront() const;
+  size_t GetRear() const;
+
+  void SetGrowth(const Growth& growth_);
+
+  void reserve(size_t capacity_);
+
+  size_t Size() const;
+  void enqueue(const T& element);
+  T dequeue();
+  void Clear();
+  void Sync();
+
+  T operator[](size_t index) const;
+
+  bool IsEmpty() const;
+  bool IsFull() const;
+};
+
+template <class T, class Growth>
+inline typename TMappedQueue<T, Growth>::THeader* TMappedQueue<T, Growth>::Header() const
+{
+  return reinterpret_cast<THeader*>(base);
+}
+
+template <class T, class Growth>
+inline typename TMappedQueue<T, Growth>::TLayout& TMappedQueue<T, Growth>::Layout() const
+{
+  return Header()->layouts[Load(Header()->active)];
+}
+
+template <class T, class Growth>
+inline T* TMappedQueue<T, Growth>::Memory() const
+{
+  return reinterpret_cast<T*>(base + headerSize);
+}
+
+template <class T, class Growth>
+inline size_t TMappedQueue<T, Growth>::FileSize(size_t capacity_)
+{
+  return headerSize + capacity_ * sizeof(T);
+}
+
+template <class T, class Growth>
+inline uint64_t TMappedQueue<T, Growth>::Load(const uint64_t& word)
+{
+  return atomic_ref<uint64_t>(const_cast<uint64_t&>(word)).load(memory_order_acquire);
+}
+
+template <class T, class Growth>
+inline void TMappedQueue<T, Growth>::Store(uint64_t& word, uint64_t value)
+{
+  atomic_ref<uint64_t>(word).store(value, memory_order_release);
+}
+
+template <class T, class Growth>
+inline T TMappedQueue<T, Growth>::Read(const T* slot)
+{
+  array<unsigned char, sizeof(T)> bytes;
+  memcpy(bytes.data(), slot, sizeof(T));
+  return bit_cast<T>(bytes);
+}
+
+template <class T, class Growth>
+inline void TMappedQueue<T, Growth>::Map(size_t size)
+{
+  void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED)
+    throw("Cannot map file");
+  base = static_cast<char*>(p);
+  mapped = size;
+}
+
+template <class T, class Growth>
+inline void TMappedQueue<T, Growth>::Unmap()
+{
+  if (base != nullptr)
+    munmap(base, mapped);
+  base = nullptr;
+  mapped = 0;
+}
+
+template <class T, class Growth>
+inline void TMappedQueue<T, Growth>::Resize(size_t capacity_)
+{
+  TLayout layout = Layout();
+  size_t capacity = layout.capacity;
+  size_t count = layout.tail - layout.head;
+  size_t head = capacity == 0 ? 0 : layout.head % capacity;
+  size_t wrapped = head + count > capacity ? head + count - capacity : 0;
+  capacity_ = max(capacity_, capacity + wrapped);
+  if (capacity_ > (SIZE_MAX - headerSize) / sizeof(T))
+    throw("Wrong capacity");
+
+  if (ftruncate(fd, FileSize(capacity_)) != 0)
+    throw("Cannot resize file");
+  char* old = base;
+  size_t oldMapped = mapped;
+  Map(FileSize(capacity_));
+  munmap(old, oldMapped);
+
+  memcpy(Memory() + capacity, Memory(), wrapped * sizeof(T));
+  THeader* header = Header();
+  uint64_t next = 1 - Load(header->active);
+  header->layouts[next] = { capacity_, head, head + count };
+  Store(header->active, next);
+}
+
+template <class T, class Growth>
+inline TMappedQueue<T, Growth>::TMappedQueue(const string& path, size_t capacity_) : fd(-1), mapped(0), base(nullptr)
+{
+  fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0)
+    throw("Cannot open file");
+
+  struct stat st;
+  if (fstat(fd, &st) != 0)
+  {
+    close(fd);
+    throw("Cannot open file");
+  }
+
+  try
+  {
+    if (st.st_size == 0)
+    {
+      if (ftruncate(fd, FileSize(capacity_)) != 0)
+        throw("Cannot resize file");
+      Map(FileSize(capacity_));
+      THeader* header = Header();
+      header->elementSize = sizeof(T);
+      header->active = 0;
+      header->layouts[0] = { capacity_, 0, 0 };
+      header->layouts[1] = { 0, 0, 0 };
+      atomic_ref<uint32_t>(header->tag).store(magic, memory_order_release);
+    }
+    else
+    {
+      if ((size_t)st.st_size < headerSize)
+        throw("Wrong file format");
+      Map(st.st_size);
+      THeader* header = Header();
+      if (header->tag != magic || header->elementSize != sizeof(T) || header->active > 1)
+        throw("Wrong file format");
+      const TLayout& layout = header->layouts[header->active];
+      if (layout.capacity > (mapped - headerSize) / sizeof(T) || layout.tail < layout.head || layout.tail - layout.head > layout.capacity)
+        throw("Wrong file format");
+      if (layout.capacity < capacity_)
+        Resize(capacity_);
+    }
+  }
+  catch (...)
+  {
+    Unmap();
+    close(fd);
+    throw;
+  }
+}
+
+template <class T, class Growth>
+inline TMappedQueue<T, Growth>::~TMappedQueue()
+{
+  Unmap();
+  close(fd);
+}
+
+template <class T, class Growth>
+inline Growth TMappedQueue<T, Growth>::GetGrowth() const
+{
+  return growth;
+}
+
+template <class T, class Growth>
+inline size_t TMappedQueue<T, Growth>::GetCapacity() const
+{
+  return Layout().capacity;
+}
+
+template <class T, class Growth>
+inline size_t TMappedQueue<T, Growth>::GetFront() const
+{
+  const TLayout& layout = Layout();
+  return layout.capacity == 0 ? 0 : Load(layout.head) % layout.capacity;
+}
+
+template <class T, class Growth>
+inline size_t TMappedQueue<T, Growth>::GetRear() const
+{
+  const TLayout& layout = Layout();
+  return layout.capacity == 0 ? 0 : Load(layout.tail) % layout.capacity;
+}
+
+template <class T, class Growth>
+inline void TMappedQueue<T, Growth>::SetGrowth(const Growth& growth_)
+{
+  growth = growth_;
+}
+
+template <class T, class Growth>
+inline void TMappedQueue<T, Growth>::reserve(size_t capacity_)
+{
+  if (capacity_ > GetCapacity())
+    Resize(capacity_);
+}
+
+template <class T, class Growth>
+inline size_t TMappedQueue<T, Growth>::Size() const
+{
+  const TLayout& layout = Layout();
+  return Load(layout.tail) - Load(layout.head);
+}
+
+template <class T, class Growth>
+inline void TMappedQueue<T, Growth>::enqueue(const T& element)
+{
+  if (IsFull())
+  {
+    size_t capacity = GetCapacity();
+    size_t newCap = growth.Next(capacity, capacity + 1);
+    if (newCap <= capacity)
+      throw("Full queue");
+    Resize(newCap);
+  }
+
+  TLayout& layout = Layout();
+  uint64_t tail = layout.tail;
+  memcpy(Memory() + tail % layout.capacity, &element, sizeof(T));
+  Store(layout.tail, tail + 1);
+}
+
+template <class T, class Growth>
+inline T TMappedQueue<T, Growth>::dequeue()
+{
+  if (IsEmpty())
+    throw("Empty queue");
+
+  TLayout& layout = Layout();
+  uint64_t head = layout.head;
+  T element = Read(Memory() + head % layout.capacity);
+  Store(layout.head, head + 1);
+  return element;
+}
+
+template <class T, class Growth>
+inline void TMappedQueue<T, Growth>::Clear()
+{
+  TLayout& layout = Layout();
+  Store(layout.head, Load(layout.tail));
+}
+
+template <class T, class Growth>
+inline void TMappedQueue<T, Growth>::Sync()
+{
+  if (msync(base, mapped, MS_SYNC) != 0)
+    throw("Cannot sync file");
+}
+
+template <class T, class Growth>
+inline T TMappedQueue<T, Growth>::operator[](size_t index) const
+{
+  if (index >= Size())
+    throw("Index out of range");
+  const TLayout& layout = Layout();
+  return Read(Memory() + (Load(layout.head) + index) % layout.capacity);
+}
+
+template <class T, class Growth>
+inline bool TMappedQueue<T, Growth>::IsEmpty() const
+{
+  return Size() == 0;
+}
+
+template <class T, class Growth>
+inline bool TMappedQueue<T, Growth>::IsFull() const
+{
+  return Size() == GetCapacity();
+}
+#endif
@@ -0,0 +1 @@
+#include "TPriorityQueue.h"
@@ -0,0 +1,533 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "TGrowth.h"
+#include "TStack.h"
+
+using namespace std;
+
+template <class T, class Compare = less<T>, size_t D = 4, class Alloc = allocator<T>, class Growth = TGeometricGrowth>
+class TPriorityQueue
+{
+  static_assert(D >= 2, "TPriorityQueue needs at least two children per node");
+protected:
+  TStack<T, Alloc, Growth> heap;
+  [[no_unique_address]] Compare comp;
+
+  void SiftUp(size_t index);
+  void SiftDown(size_t index);
+  void Heapify();
+public:
+  TPriorityQueue();
+  explicit TPriorityQueue(const Compare& comp_);
+  TPriorityQueue(size_t capacity_, const Compare& comp_ = Compare());
+  template <class InputIt>
+  TPriorityQueue(InputIt first, InputIt last, const Compare& comp_ = Compare());
+
+  size_t GetCapacity() const;
+  Compare GetCompare() const;
+
+  void reserve(size_t capacity_);
+  void shrink_to_fit();
+
+  size_t Size() const;
+  void push(const T& element);
+  void push(T&& element);
+  template <class... Args>
+  void emplace(Args&&... args);
+  T pop();
+  const T& top() const;
+
+  template <class InputIt>
+  void push_range(InputIt first, InputIt last);
+
+  bool IsEmpty() const;
+
+  class TIterator
+  {
+  protected:
+    const TPriorityQueue& p;
+    size_t cur;
+  public:
+    TIterator(const TPriorityQueue& queue, size_t start);
+    const T& operator*() const;
+    TIterator& operator++();
+    TIterator operator++(int);
+
+    bool operator==(const TIterator& other) const;
+    bool operator!=(const TIterator& other) const;
+  };
+
+  TIterator begin() const;
+  TIterator end() const;
+
+  template <class I, class C, size_t E, class A, class G>
+  friend istream& operator>>(istream& is, TPriorityQueue<I, C, E, A, G>& queue);
+
+  template <class O, class C, size_t E, class A, class G>
+  friend ostream& operator<<(ostream& os, const TPriorityQueue<O, C, E, A, G>& queue);
+};
+
+template <class T, class Compare = less<T>, size_t D = 4>
+class TIndexedPriorityQueue
+{
+  static_assert(D >= 2, "TIndexedPriorityQueue needs at least two children per node");
+protected:
+  static constexpr size_t absent = SIZE_MAX;
+
+  vector<size_t> heap;
+  vector<size_t> position;
+  vector<T> keys;
+  [[no_unique_address]] Compare comp;
+
+  bool Before(size_t a, size_t b) const;
+  void Place(size_t index, size_t id);
+  void SiftUp(size_t index);
+  void SiftDown(size_t index);
+  void RemoveAt(size_t index);
+public:
+  TIndexedPriorityQueue(size_t capacity_ = 0, const Compare& comp_ = Compare());
+
+  size_t GetCapacity() const;
+  const T& GetKey(size_t id) const;
+
+  size_t Size() const;
+  void push(size_t id, const T& key);
+  size_t pop();
+  size_t top() const;
+  void DecreaseKey(size_t id, const T& key);
+  void Update(size_t id, const T& key);
+  void Remove(size_t id);
+
+  bool Contains(size_t id) const;
+  bool IsEmpty() const;
+};
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline void TPriorityQueue<T, Compare, D, Alloc, Growth>::SiftUp(size_t index)
+{
+  T* a = heap.GetMemory();
+  T value = std::move(a[index]);
+  while (index > 0)
+  {
+    size_t parent = (index - 1) / D;
+    if (!comp(a[parent], value))
+      break;
+    a[index] = std::move(a[parent]);
+    index = parent;
+  }
+  a[index] = std::move(value);
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline void TPriorityQueue<T, Compare, D, Alloc, Growth>::SiftDown(size_t index)
+{
+  T* a = heap.GetMemory();
+  size_t n = heap.Size();
+  T value = std::move(a[index]);
+  while (true)
+  {
+    size_t first = index * D + 1;
+    if (first >= n)
+      break;
+    size_t last = min(first + D, n);
+    size_t best = first;
+    for (size_t child = first + 1; child < last; ++child)
+    {
+      if (comp(a[best], a[child]))
+        best = child;
+    }
+    if (!comp(value, a[best]))
+      break;
+    a[index] = std::move(a[best]);
+    index = best;
+  }
+  a[index] = std::move(value);
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline void TPriorityQueue<T, Compare, D, Alloc, Growth>::Heapify()
+{
+  size_t n = heap.Size();
+  if (n < 2)
+    return;
+  for (size_t i = (n - 2) / D + 1; i > 0; --i)
+    SiftDown(i - 1);
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline TPriorityQueue<T, Compare, D, Alloc, Growth>::TPriorityQueue() : heap(), comp() {}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline TPriorityQueue<T, Compare, D, Alloc, Growth>::TPriorityQueue(const Compare& comp_) : heap(), comp(comp_) {}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline TPriorityQueue<T, Compare, D, Alloc, Growth>::TPriorityQueue(size_t capacity_, const Compare& comp_) : heap(capacity_), comp(comp_) {}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+template <class InputIt>
+inline TPriorityQueue<T, Compare, D, Alloc, Growth>::TPriorityQueue(InputIt first, InputIt last, const Compare& comp_) : heap(), comp(comp_)
+{
+  heap.push_range(first, last);
+  Heapify();
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline size_t TPriorityQueue<T, Compare, D, Alloc, Growth>::GetCapacity() const
+{
+  return heap.GetCapacity();
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline Compare TPriorityQueue<T, Compare, D, Alloc, Growth>::GetCompare() const
+{
+  return comp;
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline void TPriorityQueue<T, Compare, D, Alloc, Growth>::reserve(size_t capacity_)
+{
+  heap.reserve(capacity_);
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline void TPriorityQueue<T, Compare, D, Alloc, Growth>::shrink_to_fit()
+{
+  heap.shrink_to_fit();
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline size_t TPriorityQueue<T, Compare, D, Alloc, Growth>::Size() const
+{
+  return heap.Size();
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline void TPriorityQueue<T, Compare, D, Alloc, Growth>::push(const T& element)
+{
+  heap.push(element);
+  SiftUp(heap.Size() - 1);
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline void TPriorityQueue<T, Compare, D, Alloc, Growth>::push(T&& element)
+{
+  heap.push(std::move(element));
+  SiftUp(heap.Size() - 1);
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+template <class... Args>
+inline void TPriorityQueue<T, Compare, D, Alloc, Growth>::emplace(Args&&... args)
+{
+  heap.emplace(std::forward<Args>(args)...);
+  SiftUp(heap.Size() - 1);
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline T TPriorityQueue<T, Compare, D, Alloc, Growth>::pop()
+{
+  if (heap.IsEmpty())
+    throw("Empty priority queue");
+
+  T last = heap.pop();
+  if (heap.IsEmpty())
+    return last;
+
+  T* a = heap.GetMemory();
+  T element = std::move(a[0]);
+  a[0] = std::move(last);
+  SiftDown(0);
+  return element;
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline const T& TPriorityQueue<T, Compare, D, Alloc, Growth>::top() const
+{
+  if (heap.IsEmpty())
+    throw("Empty priority queue");
+  return heap.GetMemory()[0];
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+template <class InputIt>
+inline void TPriorityQueue<T, Compare, D, Alloc, Growth>::push_range(InputIt first, InputIt last)
+{
+  size_t old = heap.Size();
+  heap.push_range(first, last);
+  size_t n = heap.Size() - old;
+  if (n >= old)
+    Heapify();
+  else
+  {
+    for (size_t i = old; i < old + n; ++i)
+      SiftUp(i);
+  }
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline bool TPriorityQueue<T, Compare, D, Alloc, Growth>::IsEmpty() const
+{
+  return heap.IsEmpty();
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline TPriorityQueue<T, Compare, D, Alloc, Growth>::TIterator::TIterator(const TPriorityQueue& queue, size_t start) : p(queue), cur(start) {}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline const T& TPriorityQueue<T, Compare, D, Alloc, Growth>::TIterator::operator*() const
+{
+  return p.heap.GetMemory()[cur];
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline typename TPriorityQueue<T, Compare, D, Alloc, Growth>::TIterator& TPriorityQueue<T, Compare, D, Alloc, Growth>::TIterator::operator++()
+{
+  cur++;
+  return *this;
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline typename TPriorityQueue<T, Compare, D, Alloc, Growth>::TIterator TPriorityQueue<T, Compare, D, Alloc, Growth>::TIterator::operator++(int)
+{
+  TIterator temp = *this;
+  ++(*this);
+  return temp;
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline bool TPriorityQueue<T, Compare, D, Alloc, Growth>::TIterator::operator==(const TIterator& other) const
+{
+  return &p == &other.p && cur == other.cur;
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline bool TPriorityQueue<T, Compare, D, Alloc, Growth>::TIterator::operator!=(const TIterator& other) const
+{
+  return !(*this == other);
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline typename TPriorityQueue<T, Compare, D, Alloc, Growth>::TIterator TPriorityQueue<T, Compare, D, Alloc, Growth>::begin() const
+{
+  return TIterator(*this, 0);
+}
+
+template <class T, class Compare, size_t D, class Alloc, class Growth>
+inline typename TPriorityQueue<T, Compare, D, Alloc, Growth>::TIterator TPriorityQueue<T, Compare, D, Alloc, Growth>::end() const
+{
+  return TIterator(*this, heap.Size());
+}
+
+template <class I, class C, size_t E, class A, class G>
+inline istream& operator>>(istream& is, TPriorityQueue<I, C, E, A, G>& queue)
+{
+  queue.heap.SetTop(0);
+  size_t n;
+  is >> n;
+
+  if (n > queue.heap.GetCapacity())
+    queue.heap.SetCapacity(n);
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    I element;
+    is >> element;
+    queue.heap.push(std::move(element));
+  }
+  queue.Heapify();
+
+  return is;
+}
+
+template <class O, class C, size_t E, class A, class G>
+inline ostream& operator<<(ostream& os, const TPriorityQueue<O, C, E, A, G>& queue)
+{
+  const O* first = queue.heap.GetMemory();
+  vector<O> sorted(first, first + queue.heap.Size());
+  sort(sorted.begin(), sorted.end(), [&](const O& a, const O& b) { return queue.comp(b, a); });
+  os << "[";
+  for (size_t i = 0; i < sorted.size(); ++i)
+  {
+    os << sorted[i];
+    if (i < sorted.size() - 1)
+      os << ", ";
+  }
+  os << "]";
+  return os;
+}
+
+template <class T, class Compare, size_t D>
+inline bool TIndexedPriorityQueue<T, Compare, D>::Before(size_t a, size_t b) const
+{
+  return comp(keys[b], keys[a]);
+}
+
+template <class T, class Compare, size_t D>
+inline void TIndexedPriorityQueue<T, Compare, D>::Place(size_t index, size_t id)
+{
+  heap[index] = id;
+  position[id] = index;
+}
+
+template <class T, class Compare, size_t D>
+inline void TIndexedPriorityQueue<T, Compare, D>::SiftUp(size_t index)
+{
+  size_t id = heap[index];
+  while (index > 0)
+  {
+    size_t parent = (index - 1) / D;
+    if (!Before(id, heap[parent]))
+      break;
+    Place(index, heap[parent]);
+    index = parent;
+  }
+  Place(index, id);
+}
+
+template <class T, class Compare, size_t D>
+inline void TIndexedPriorityQueue<T, Compare, D>::SiftDown(size_t index)
+{
+  size_t id = heap[index];
+  size_t n = heap.size();
+  while (true)
+  {
+    size_t first = index * D + 1;
+    if (first >= n)
+      break;
+    size_t last = min(first + D, n);
+    size_t best = first;
+    for (size_t child = first + 1; child < last; ++child)
+    {
+      if (Before(heap[child], heap[best]))
+        best = child;
+    }
+    if (!Before(heap[best], id))
+      break;
+    Place(index, heap[best]);
+    index = best;
+  }
+  Place(index, id);
+}
+
+template <class T, class Compare, size_t D>
+inline void TIndexedPriorityQueue<T, Compare, D>::RemoveAt(size_t index)
+{
+  size_t id = heap[index];
+  size_t moved = heap.back();
+  heap.pop_back();
+  position[id] = absent;
+  if (index == heap.size())
+    return;
+
+  Place(index, moved);
+  SiftUp(index);
+  SiftDown(position[moved]);
+}
+
+template <class T, class Compare, size_t D>
+inline TIndexedPriorityQueue<T, Compare, D>::TIndexedPriorityQueue(size_t capacity_, const Compare& comp_) : position(capacity_, absent), keys(capacity_), comp(comp_)
+{
+  heap.reserve(capacity_);
+}
+
+template <class T, class Compare, size_t D>
+inline size_t TIndexedPriorityQueue<T, Compare, D>::GetCapacity() const
+{
+  return position.size();
+}
+
+template <class T, class Compare, size_t D>
+inline const T& TIndexedPriorityQueue<T, Compare, D>::GetKey(size_t id) const
+{
+  if (!Contains(id))
+    throw("Wrong id");
+  return keys[id];
+}
+
+template <class T, class Compare, size_t D>
+inline size_t TIndexedPriorityQueue<T, Compare, D>::Size() const
+{
+  return heap.size();
+}
+
+template <class T, class Compare, size_t D>
+inline void TIndexedPriorityQueue<T, Compare, D>::push(size_t id, const T& key)
+{
+  if (Contains(id))
+    throw("Duplicate id");
+  if (id >= position.size())
+  {
+    position.resize(max(id + 1, position.size() * 2), absent);
+    keys.resize(position.size());
+  }
+
+  keys[id] = key;
+  heap.push_back(id);
+  position[id] = heap.size() - 1;
+  SiftUp(heap.size() - 1);
+}
+
+template <class T, class Compare, size_t D>
+inline size_t TIndexedPriorityQueue<T, Compare, D>::pop()
+{
+  if (heap.empty())
+    throw("Empty priority queue");
+  size_t id = heap[0];
+  RemoveAt(0);
+  return id;
+}
+
+template <class T, class Compare, size_t D>
+inline size_t TIndexedPriorityQueue<T, Compare, D>::top() const
+{
+  if (heap.empty())
+    throw("Empty priority queue");
+  return heap[0];
+}
+
+template <class T, class Compare, size_t D>
+inline void TIndexedPriorityQueue<T, Compare, D>::DecreaseKey(size_t id, const T& key)
+{
+  if (!Contains(id))
+    throw("Wrong id");
+  if (comp(key, keys[id]))
+    throw("Wrong key");
+  keys[id] = key;
+  SiftUp(position[id]);
+}
+
+template <class T, class Compare, size_t D>
+inline void TIndexedPriorityQueue<T, Compare, D>::Update(size_t id, const T& key)
+{
+  if (!Contains(id))
+    throw("Wrong id");
+  keys[id] = key;
+  SiftUp(position[id]);
+  SiftDown(position[id]);
+}
+
+template <class T, class Compare, size_t D>
+inline void TIndexedPriorityQueue<T, Compare, D>::Remove(size_t id)
+{
+  if (!Contains(id))
+    throw("Wrong id");
+  RemoveAt(position[id]);
+}
+
+template <class T, class Compare, size_t D>
+inline bool TIndexedPriorityQueue<T, Compare, D>::Contains(size_t id) const
+{
+  return id < position.size() && position[id] != absent;
+}
+
+template <class T, class Compare, size_t D>
+inline bool TIndexedPriorityQueue<T, Compare, D>::IsEmpty() const
+{
+  return heap.empty();
+}
@@ -1,25 +1,104 @@
 #pragma once
+#include <algorithm>
+#include <bit>
 #include <cstddef>
+#include <cstring>
+#include <iterator>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include "TBinary.h"
+#include "TGrowth.h"
+#include "TInlineBuffer.h"
+#include "TStats.h"
 
 using namespace std;
 
-template <class T>
+struct TModuloIndex
+{
+  static constexpr size_t Capacity(size_t capacity)
+  {
+    return capacity;
+  }
+
+  static constexpr size_t Slot(size_t position, size_t)
+  {
+    return position;
+  }
+
+  static constexpr size_t Offset(size_t position, size_t offset, size_t capacity)
+  {
+    return (position + offset) % capacity;
+  }
+
+  static constexpr size_t Advance(size_t position, size_t capacity)
+  {
+    return position + 1 == capacity ? 0 : position + 1;
+  }
+};
+
+struct TPow2Index
+{
+  static constexpr size_t Capacity(size_t capacity)
+  {
+    return capacity == 0 ? 0 : bit_ceil(capacity);
+  }
+
+  static constexpr size_t Slot(size_t position, size_t capacity)
+  {
+    return position & (capacity - 1);
+  }
+
+  static constexpr size_t Offset(size_t position, size_t offset, size_t capacity)
+  {
+    return (position + offset) & (capacity - 1);
+  }
+
+  static constexpr size_t Advance(size_t position, size_t)
+  {
+    return position + 1;
+  }
+};
+
+template <class T, class Index = TModuloIndex, class Alloc = allocator<T>, class Growth = TGeometricGrowth, class Stats = TNoStats, size_t N = 0>
 class TQueue
 {
+  static_assert(Index::Capacity(N) == N, "Inline capacity must be valid for the index policy");
 protected:
+  using Traits = allocator_traits<Alloc>;
+
+  [[no_unique_address]] Alloc alloc;
+  [[no_unique_address]] Growth growth;
+  [[no_unique_address]] Stats stats;
   size_t capacity;
   size_t head;
   size_t tail;
   size_t count;
   T* memory;
+  [[no_unique_address]] TInlineBuffer<T, N> buffer;
+
+  T* Allocate(size_t capacity_);
+  void Deallocate(T* memory_, size_t capacity_);
+  void MoveRange(T* dst, T* src, size_t n);
+  size_t NextCapacity() const;
+  bool CanGrow() const;
+  bool GrowTo(size_t required);
+  size_t FrontSegment() const;
+  void Relocate(T* newMem, size_t newHead, size_t newCap);
+  void Clear();
 public:
   TQueue();
-  TQueue(size_t capacity_);
+  explicit TQueue(const Alloc& alloc_);
+  TQueue(size_t capacity_, const Alloc& alloc_ = Alloc());
   TQueue(const TQueue& other);
   TQueue(TQueue&& other);
   ~TQueue();
 
+  Alloc GetAllocator() const;
+  Growth GetGrowth() const;
+  const Stats& GetStats() const;
   size_t GetCapacity() const;
   size_t GetFront() const;
   size_t GetRear() const;
@@ -31,13 +110,35 @@ public:
   void SetRear(size_t tail_);
   void SetCount(size_t count_);
   void SetMemory(T* memory_);
+  void SetGrowth(const Growth& growth_);
+  void ResetStats();
+
+  void reserve(size_t capacity_);
+  void shrink_to_fit();
 
   size_t Size() const;
   void enqueue(const T& element);
+  void enqueue(T&& element);
+  template <class... Args>
+  T& emplace(Args&&... args);
   T dequeue();
 
-  bool operator==(const TQueue<T>& other) const;
-  bool operator!=(const TQueue<T>& other) const;
+  bool try_enqueue(const T& element);
+  bool try_enqueue(T&& element);
+  bool try_dequeue(T& element) noexcept(is_nothrow_move_assignable_v<T>);
+  optional<T> try_dequeue() noexcept(is_nothrow_move_constructible_v<T>);
+  T& front() noexcept;
+  const T& front() const noexcept;
+
+  template <class InputIt>
+  size_t enqueue_range(InputIt first, InputIt last);
+  size_t enqueue_range(span<const T> elements);
+  template <class OutputIt>
+  size_t dequeue_range(OutputIt out, size_t n);
+  size_t dequeue_range(span<T> out);
+
+  bool operator==(const TQueue& other) const;
+  bool operator!=(const TQueue& other) const;
   T operator[](size_t index) const;
 
   bool IsEmpty() const;
@@ -46,11 +147,11 @@ public:
   class TIterator
   {
   protected:
-    TQueue<T>& p;
+    TQueue& p;
     size_t cur;
     size_t prev;
   public:
-    TIterator(TQueue<T> &queue, size_t start, size_t cnt);
+    TIterator(TQueue& queue, size_t start, size_t cnt);
     T& operator*();
     TIterator& operator++();
     TIterator operator++(int);
@@ -62,291 +163,738 @@ public:
   TIterator begin();
   TIterator end();
 
-  template <class I>
-  friend istream& operator>>(istream& is, TQueue<I>& queue);
+  template <class I, class Idx, class A, class G, class S, size_t M>
+  friend istream& operator>>(istream& is, TQueue<I, Idx, A, G, S, M>& queue);
+
+  template <class O, class Idx, class A, class G, class S, size_t M>
+  friend ostream& operator<<(ostream& os, const TQueue<O, Idx, A, G, S, M>& queue);
+
+  template <class I, class Idx, class A, class G, class S, size_t M>
+  friend istream& ReadBinary(istream& is, TQueue<I, Idx, A, G, S, M>& queue);
 
-  template <class O>
-  friend ostream& operator<<(ostream& os, const TQueue<O>& queue);
+  template <class O, class Idx, class A, class G, class S, size_t M>
+  friend ostream& WriteBinary(ostream& os, const TQueue<O, Idx, A, G, S, M>& queue);
 };
 
-template <class T>
-inline TQueue<T>::TQueue() : capacity(0), head(0), tail(0), count(0), memory(new T[capacity]) {}
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline T* TQueue<T, Index, Alloc, Growth, Stats, N>::Allocate(size_t capacity_)
+{
+  if (capacity_ <= N)
+    return buffer.Data();
+  return Traits::allocate(alloc, capacity_);
+}
 
-template <class T>
-inline TQueue<T>::TQueue(size_t capacity_) : capacity(capacity_), head(0), tail(0), count(0), memory(new T[capacity]) {}
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline void TQueue<T, Index, Alloc, Growth, Stats, N>::Deallocate(T* memory_, size_t capacity_)
+{
+  if (memory_ != nullptr && memory_ != buffer.Data())
+    Traits::deallocate(alloc, memory_, capacity_);
+}
 
-template <class T>
-inline TQueue<T>::TQueue(const TQueue& other) : capacity(other.capacity), head(other.head), tail(other.tail), count(other.count), memory(new T[capacity])
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline void TQueue<T, Index, Alloc, Growth, Stats, N>::MoveRange(T* dst, T* src, size_t n)
 {
-  for (size_t i = 0; i < capacity; ++i)
-    memory[i] = other.memory[i];
+  if (n == 0)
+    return;
+
+  if constexpr (is_trivially_copyable_v<T>)
+    memcpy(dst, src, n * sizeof(T));
+  else
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      Traits::construct(alloc, dst + i, std::move(src[i]));
+      Traits::destroy(alloc, src + i);
+    }
+  }
 }
 
-template <class T>
-inline TQueue<T>::TQueue(TQueue&& other) : capacity(other.capacity), head(other.head), tail(other.tail), count(other.count), memory(other.memory)
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline size_t TQueue<T, Index, Alloc, Growth, Stats, N>::NextCapacity() const
 {
-  other.memory = nullptr;
-  other.capacity = 0;
+  size_t newCap = Index::Capacity(growth.Next(capacity, capacity + 1));
+  if (newCap <= capacity || newCap > growth.Limit())
+    throw("Full queue");
+  return newCap;
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline bool TQueue<T, Index, Alloc, Growth, Stats, N>::CanGrow() const
+{
+  size_t newCap = Index::Capacity(growth.Next(capacity, capacity + 1));
+  return newCap > capacity && newCap <= growth.Limit();
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline bool TQueue<T, Index, Alloc, Growth, Stats, N>::GrowTo(size_t required)
+{
+  if (required <= capacity)
+    return true;
+
+  size_t newCap = Index::Capacity(growth.Next(capacity, required));
+  if (newCap < required || newCap > growth.Limit())
+    return false;
+  SetCapacity(newCap);
+  return true;
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline size_t TQueue<T, Index, Alloc, Growth, Stats, N>::FrontSegment() const
+{
+  return min(count, capacity - Index::Slot(head, capacity));
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline void TQueue<T, Index, Alloc, Growth, Stats, N>::Relocate(T* newMem, size_t newHead, size_t newCap)
+{
+  stats.OnResize(count * sizeof(T));
+  size_t done = 0;
+  while (done < count)
+  {
+    size_t from = Index::Offset(head, done, capacity);
+    size_t to = (newHead + done) % newCap;
+    size_t n = min(count - done, min(capacity - from, newCap - to));
+    MoveRange(newMem + to, memory + from, n);
+    done += n;
+  }
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline void TQueue<T, Index, Alloc, Growth, Stats, N>::Clear()
+{
+  if constexpr (!is_trivially_destructible_v<T>)
+  {
+    for (size_t i = 0; i < count; ++i)
+      Traits::destroy(alloc, memory + Index::Offset(head, i, capacity));
+  }
+  head = 0;
+  tail = 0;
+  count = 0;
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline TQueue<T, Index, Alloc, Growth, Stats, N>::TQueue() : alloc(), capacity(N), head(0), tail(0), count(0), memory(Allocate(N)) {}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline TQueue<T, Index, Alloc, Growth, Stats, N>::TQueue(const Alloc& alloc_) : alloc(alloc_), capacity(N), head(0), tail(0), count(0), memory(Allocate(N)) {}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline TQueue<T, Index, Alloc, Growth, Stats, N>::TQueue(size_t capacity_, const Alloc& alloc_) : alloc(alloc_), capacity(Index::Capacity(max(capacity_, N))), head(0), tail(0), count(0), memory(Allocate(capacity)) {}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline TQueue<T, Index, Alloc, Growth, Stats, N>::TQueue(const TQueue& other) : alloc(Traits::select_on_container_copy_construction(other.alloc)), growth(other.growth), capacity(other.capacity), head(other.head), tail(other.tail), count(0), memory(Allocate(capacity))
+{
+  size_t first = other.FrontSegment();
+  if constexpr (is_trivially_copyable_v<T>)
+  {
+    if (other.count != 0)
+    {
+      size_t front = Index::Slot(head, capacity);
+      memcpy(memory + front, other.memory + front, first * sizeof(T));
+      memcpy(memory, other.memory, (other.count - first) * sizeof(T));
+    }
+    count = other.count;
+    return;
+  }
+
+  size_t front = Index::Slot(head, capacity);
+  try
+  {
+    for (; count < other.count; ++count)
+    {
+      size_t i = count < first ? front + count : count - first;
+      Traits::construct(alloc, memory + i, other.memory[i]);
+    }
+  }
+  catch (...)
+  {
+    Clear();
+    Deallocate(memory, capacity);
+    throw;
+  }
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline TQueue<T, Index, Alloc, Growth, Stats, N>::TQueue(TQueue&& other) : alloc(std::move(other.alloc)), growth(other.growth), stats(std::move(other.stats)), capacity(other.capacity), head(other.head), tail(other.tail), count(other.count), memory(other.memory)
+{
+  if (other.memory == other.buffer.Data() && N != 0)
+  {
+    memory = buffer.Data();
+    other.Relocate(memory, 0, capacity);
+    head = 0;
+    tail = Index::Offset(0, count, capacity);
+  }
+  other.memory = other.buffer.Data();
+  other.capacity = N;
   other.head = 0;
   other.tail = 0;
   other.count = 0;
 }
 
-template <class T>
-inline TQueue<T>::~TQueue()
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline TQueue<T, Index, Alloc, Growth, Stats, N>::~TQueue()
+{
+  Clear();
+  Deallocate(memory, capacity);
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline Alloc TQueue<T, Index, Alloc, Growth, Stats, N>::GetAllocator() const
 {
-  delete[] memory;
+  return alloc;
 }
 
-template <class T>
-inline size_t TQueue<T>::GetCapacity() const
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline Growth TQueue<T, Index, Alloc, Growth, Stats, N>::GetGrowth() const
+{
+  return growth;
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline const Stats& TQueue<T, Index, Alloc, Growth, Stats, N>::GetStats() const
+{
+  return stats;
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline void TQueue<T, Index, Alloc, Growth, Stats, N>::ResetStats()
+{
+  stats = Stats();
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline size_t TQueue<T, Index, Alloc, Growth, Stats, N>::GetCapacity() const
 {
   return capacity;
 }
 
-template <class T>
-inline size_t TQueue<T>::GetFront() const
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline size_t TQueue<T, Index, Alloc, Growth, Stats, N>::GetFront() const
 {
-  return head;
+  return Index::Slot(head, capacity);
 }
 
-template <class T>
-inline size_t TQueue<T>::GetRear() const
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline size_t TQueue<T, Index, Alloc, Growth, Stats, N>::GetRear() const
 {
-  return tail;
+  return Index::Slot(tail, capacity);
 }
 
-template <class T>
-inline size_t TQueue<T>::GetCount() const
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline size_t TQueue<T, Index, Alloc, Growth, Stats, N>::GetCount() const
 {
   return count;
 }
 
-template <class T>
-inline T* TQueue<T>::GetMemory() const
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline T* TQueue<T, Index, Alloc, Growth, Stats, N>::GetMemory() const
 {
   return memory;
 }
 
-template <class T>
-inline void TQueue<T>::SetCapacity(size_t capacity_)
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline void TQueue<T, Index, Alloc, Growth, Stats, N>::SetCapacity(size_t capacity_)
 {
+  capacity_ = Index::Capacity(max(capacity_, N));
   if (capacity_ < count)
     throw("Wrong capacity");
+  if (capacity_ == capacity && memory == buffer.Data())
+    return;
 
-  T* newMem = new T[capacity_];
-  for (size_t i = 0; i < count; ++i)
-    newMem[i] = memory[(head + i) % capacity];
+  T* newMem = Allocate(capacity_);
+  Relocate(newMem, 0, capacity_);
 
-  delete[] memory;
+  Deallocate(memory, capacity);
   memory = newMem;
   head = 0;
-  tail = count;
+  tail = capacity_ == 0 ? 0 : Index::Offset(0, count, capacity_);
   capacity = capacity_;
 }
 
-template <class T>
-inline void TQueue<T>::SetFront(size_t head_)
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline void TQueue<T, Index, Alloc, Growth, Stats, N>::SetFront(size_t head_)
 {
   if (head_ >= capacity)
     throw("Wrong head");
+  if (head_ == Index::Slot(head, capacity))
+    return;
+
+  if (memory == buffer.Data())
+  {
+    T* temp = Traits::allocate(alloc, capacity);
+    Relocate(temp, 0, capacity);
+    for (size_t i = 0; i < count; ++i)
+      MoveRange(memory + (head_ + i) % capacity, temp + i, 1);
+    Traits::deallocate(alloc, temp, capacity);
+    head = head_;
+    tail = Index::Offset(head, count, capacity);
+    return;
+  }
+
+  T* newMem = Allocate(capacity);
+  Relocate(newMem, head_, capacity);
+
+  Deallocate(memory, capacity);
+  memory = newMem;
   head = head_;
+  tail = Index::Offset(head, count, capacity);
 }
 
-template <class T>
-inline void TQueue<T>::SetRear(size_t tail_)
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline void TQueue<T, Index, Alloc, Growth, Stats, N>::SetRear(size_t tail_)
 {
   if (tail_ >= capacity)
     throw("Wrong tail");
-  tail = tail_;
+  SetFront((tail_ + capacity - count) % capacity);
 }
 
-template <class T>
-inline void TQueue<T>::SetCount(size_t count_)
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline void TQueue<T, Index, Alloc, Growth, Stats, N>::SetCount(size_t count_)
 {
   if (count_ > capacity)
     throw("Wrong count");
-  count = count_;
+
+  for (; count > count_; --count)
+    Traits::destroy(alloc, memory + Index::Offset(head, count - 1, capacity));
+  for (; count < count_; ++count)
+    Traits::construct(alloc, memory + Index::Offset(head, count, capacity));
+  tail = capacity == 0 ? 0 : Index::Offset(head, count, capacity);
 }
 
-template <class T>
-inline void TQueue<T>::SetMemory(T* memory_)
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline void TQueue<T, Index, Alloc, Growth, Stats, N>::SetMemory(T* memory_)
 {
-  delete[] memory;
+  size_t head_ = head;
+  size_t tail_ = tail;
+  size_t count_ = count;
+  Clear();
+  Deallocate(memory, capacity);
   memory = memory_;
+  head = head_;
+  tail = tail_;
+  count = count_;
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline void TQueue<T, Index, Alloc, Growth, Stats, N>::SetGrowth(const Growth& growth_)
+{
+  growth = growth_;
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline void TQueue<T, Index, Alloc, Growth, Stats, N>::reserve(size_t capacity_)
+{
+  if (capacity_ <= capacity)
+    return;
+  if (Index::Capacity(capacity_) > growth.Limit())
+    throw("Wrong capacity");
+  SetCapacity(capacity_);
 }
 
-template <class T>
-inline size_t TQueue<T>::Size() const
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline void TQueue<T, Index, Alloc, Growth, Stats, N>::shrink_to_fit()
+{
+  if (capacity != Index::Capacity(count))
+    SetCapacity(count);
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline size_t TQueue<T, Index, Alloc, Growth, Stats, N>::Size() const
 {
   return count;
 }
 
-template <class T>
-inline void TQueue<T>::enqueue(const T& element)
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline void TQueue<T, Index, Alloc, Growth, Stats, N>::enqueue(const T& element)
+{
+  emplace(element);
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline void TQueue<T, Index, Alloc, Growth, Stats, N>::enqueue(T&& element)
+{
+  emplace(std::move(element));
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+template <class... Args>
+inline T& TQueue<T, Index, Alloc, Growth, Stats, N>::emplace(Args&&... args)
 {
+  typename Stats::TTimer timer(stats, true);
   if (IsFull())
   {
-    if (capacity == 0)
+    size_t newCap = NextCapacity();
+    T* newMem = Allocate(newCap);
+    try
     {
-      capacity = 10;
-      memory = new T[capacity];
+      Traits::construct(alloc, newMem + count, std::forward<Args>(args)...);
     }
-    else
+    catch (...)
     {
-      size_t newCap = capacity * 2;
-      T* newMem = new T[newCap];
-
-      for (size_t i = 0; i < count; ++i)
-        newMem[i] = memory[(head + i) % capacity];
-
-      delete[] memory;
-      memory = newMem;
-      head = 0;
-      tail = count;
-      capacity = newCap;
+      Deallocate(newMem, newCap);
+      throw;
     }
+    Relocate(newMem, 0, newCap);
+
+    Deallocate(memory, capacity);
+    memory = newMem;
+    head = 0;
+    tail = count;
+    capacity = newCap;
   }
+  else
+    Traits::construct(alloc, memory + Index::Slot(tail, capacity), std::forward<Args>(args)...);
 
-  memory[tail] = element;
-  tail = (tail + 1) % capacity;
+  T& element = memory[Index::Slot(tail, capacity)];
+  tail = Index::Advance(tail, capacity);
   count++;
+  stats.OnPush(1, count);
+  return element;
 }
 
-template <class T>
-inline T TQueue<T>::dequeue()
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline T TQueue<T, Index, Alloc, Growth, Stats, N>::dequeue()
 {
   if (IsEmpty())
+  {
+    stats.OnEmptyPop();
     throw("Empty queue");
+  }
+  typename Stats::TTimer timer(stats, false);
 
-  T element = memory[head];
-  head = (head + 1) % capacity;
+  T* front = memory + Index::Slot(head, capacity);
+  T element = std::move(*front);
+  Traits::destroy(alloc, front);
+  head = Index::Advance(head, capacity);
   count--;
+  stats.OnPop(1);
   return element;
 }
 
-template <class T>
-inline bool TQueue<T>::operator==(const TQueue<T>& other) const
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline bool TQueue<T, Index, Alloc, Growth, Stats, N>::try_enqueue(const T& element)
+{
+  if (IsFull() && !CanGrow())
+    return false;
+  emplace(element);
+  return true;
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline bool TQueue<T, Index, Alloc, Growth, Stats, N>::try_enqueue(T&& element)
+{
+  if (IsFull() && !CanGrow())
+    return false;
+  emplace(std::move(element));
+  return true;
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline bool TQueue<T, Index, Alloc, Growth, Stats, N>::try_dequeue(T& element) noexcept(is_nothrow_move_assignable_v<T>)
+{
+  if (IsEmpty())
+  {
+    stats.OnEmptyPop();
+    return false;
+  }
+  typename Stats::TTimer timer(stats, false);
+  size_t slot = Index::Slot(head, capacity);
+  element = std::move(memory[slot]);
+  Traits::destroy(alloc, memory + slot);
+  head = Index::Advance(head, capacity);
+  count--;
+  stats.OnPop(1);
+  return true;
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline optional<T> TQueue<T, Index, Alloc, Growth, Stats, N>::try_dequeue() noexcept(is_nothrow_move_constructible_v<T>)
+{
+  if (IsEmpty())
+  {
+    stats.OnEmptyPop();
+    return nullopt;
+  }
+  typename Stats::TTimer timer(stats, false);
+  size_t slot = Index::Slot(head, capacity);
+  optional<T> element(std::move(memory[slot]));
+  Traits::destroy(alloc, memory + slot);
+  head = Index::Advance(head, capacity);
+  count--;
+  stats.OnPop(1);
+  return element;
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline T& TQueue<T, Index, Alloc, Growth, Stats, N>::front() noexcept
+{
+  return memory[Index::Slot(head, capacity)];
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline const T& TQueue<T, Index, Alloc, Growth, Stats, N>::front() const noexcept
+{
+  return memory[Index::Slot(head, capacity)];
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+template <class InputIt>
+inline size_t TQueue<T, Index, Alloc, Growth, Stats, N>::enqueue_range(InputIt first, InputIt last)
+{
+  if constexpr (forward_iterator<InputIt>)
+  {
+    size_t n = distance(first, last);
+    if (!GrowTo(count + n))
+      GrowTo(min(count + n, growth.Limit()));
+    n = min(n, capacity - count);
+    if (n == 0)
+      return 0;
+
+    size_t back = Index::Slot(tail, capacity);
+    size_t firstRun = min(n, capacity - back);
+    if constexpr (contiguous_iterator<InputIt> && is_trivially_copyable_v<T> && is_same_v<iter_value_t<InputIt>, T>)
+    {
+      const T* src = to_address(first);
+      memcpy(memory + back, src, firstRun * sizeof(T));
+      memcpy(memory, src + firstRun, (n - firstRun) * sizeof(T));
+    }
+    else
+    {
+      for (size_t i = 0; i < n; ++i, ++first)
+        Traits::construct(alloc, memory + (i < firstRun ? back + i : i - firstRun), *first);
+    }
+
+    tail = Index::Offset(tail, n, capacity);
+    count += n;
+    stats.OnPush(n, count);
+    return n;
+  }
+  else
+  {
+    size_t n = 0;
+    for (; first != last; ++first, ++n)
+    {
+      if (IsFull() && !GrowTo(count + 1))
+        break;
+      Traits::construct(alloc, memory + Index::Slot(tail, capacity), *first);
+      tail = Index::Advance(tail, capacity);
+      count++;
+    }
+    stats.OnPush(n, count);
+    return n;
+  }
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline size_t TQueue<T, Index, Alloc, Growth, Stats, N>::enqueue_range(span<const T> elements)
+{
+  return enqueue_range(elements.begin(), elements.end());
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+template <class OutputIt>
+inline size_t TQueue<T, Index, Alloc, Growth, Stats, N>::dequeue_range(OutputIt out, size_t n)
+{
+  if (n != 0 && count == 0)
+    stats.OnEmptyPop();
+  n = min(n, count);
+  if (n == 0)
+    return 0;
+
+  size_t front = Index::Slot(head, capacity);
+  size_t firstRun = min(n, capacity - front);
+  if constexpr (is_same_v<OutputIt, T*> && is_trivially_copyable_v<T>)
+  {
+    memcpy(out, memory + front, firstRun * sizeof(T));
+    memcpy(out + firstRun, memory, (n - firstRun) * sizeof(T));
+  }
+  else
+  {
+    for (size_t i = 0; i < n; ++i, ++out)
+    {
+      T* element = memory + (i < firstRun ? front + i : i - firstRun);
+      *out = std::move(*element);
+      Traits::destroy(alloc, element);
+    }
+  }
+
+  head = Index::Offset(head, n, capacity);
+  count -= n;
+  stats.OnPop(n);
+  return n;
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline size_t TQueue<T, Index, Alloc, Growth, Stats, N>::dequeue_range(span<T> out)
+{
+  return dequeue_range(out.data(), out.size());
+}
+
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline bool TQueue<T, Index, Alloc, Growth, Stats, N>::operator==(const TQueue<T, Index, Alloc, Growth, Stats, N>& other) const
 {
   if (count != other.count)
     return false;
 
   for (size_t i = 0; i < count; ++i)
   {
-    if (memory[(head + i) % capacity] != other.memory[(other.head + i) % other.capacity])
+    if (memory[Index::Offset(head, i, capacity)] != other.memory[Index::Offset(other.head, i, other.capacity)])
       return false;
   }
   return true;
 }
 
-template <class T>
-inline bool TQueue<T>::operator!=(const TQueue<T>& other) const
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline bool TQueue<T, Index, Alloc, Growth, Stats, N>::operator!=(const TQueue<T, Index, Alloc, Growth, Stats, N>& other) const
 {
   return !(*this == other);
 }
 
-template <class T>
-inline T TQueue<T>::operator[](size_t index) const
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline T TQueue<T, Index, Alloc, Growth, Stats, N>::operator[](size_t index) const
 {
   if (index >= count)
     throw("Index out of range");
-  return memory[(head + index) % capacity];
+  return memory[Index::Offset(head, index, capacity)];
 }
 
-template <class T>
-inline bool TQueue<T>::IsEmpty() const
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline bool TQueue<T, Index, Alloc, Growth, Stats, N>::IsEmpty() const
 {
   return count == 0;
 }
 
-template <class T>
-inline bool TQueue<T>::IsFull() const
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline bool TQueue<T, Index, Alloc, Growth, Stats, N>::IsFull() const
 {
   return count == capacity;
 }
 
-template <class T>
-inline TQueue<T>::TIterator::TIterator(TQueue<T> &queue, size_t start, size_t cnt) : p(queue), cur(start), prev(cnt) {}
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline TQueue<T, Index, Alloc, Growth, Stats, N>::TIterator::TIterator(TQueue<T, Index, Alloc, Growth, Stats, N>& queue, size_t start, size_t cnt) : p(queue), cur(start), prev(cnt) {}
 
-template <class T>
-inline T& TQueue<T>::TIterator::operator*()
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline T& TQueue<T, Index, Alloc, Growth, Stats, N>::TIterator::operator*()
 {
-  return p.memory[cur];
+  return p.memory[Index::Slot(cur, p.capacity)];
 }
 
-template <class T>
-inline typename TQueue<T>::TIterator& TQueue<T>::TIterator::operator++()
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline typename TQueue<T, Index, Alloc, Growth, Stats, N>::TIterator& TQueue<T, Index, Alloc, Growth, Stats, N>::TIterator::operator++()
 {
-  cur = (cur + 1) % p.capacity;
+  cur = Index::Advance(cur, p.capacity);
   prev++;
   return *this;
 }
 
-template <class T>
-inline typename TQueue<T>::TIterator TQueue<T>::TIterator::operator++(int)
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline typename TQueue<T, Index, Alloc, Growth, Stats, N>::TIterator TQueue<T, Index, Alloc, Growth, Stats, N>::TIterator::operator++(int)
 {
   TIterator temp = *this;
   ++(*this);
   return temp;
 }
 
-template <class T>
-inline bool TQueue<T>::TIterator::operator==(const TIterator& other) const
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline bool TQueue<T, Index, Alloc, Growth, Stats, N>::TIterator::operator==(const TIterator& other) const
 {
   return &p == &other.p && prev == other.prev;
 }
 
-template <class T>
-inline bool TQueue<T>::TIterator::operator!=(const TIterator& other) const
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline bool TQueue<T, Index, Alloc, Growth, Stats, N>::TIterator::operator!=(const TIterator& other) const
 {
   return !(*this == other);
 }
 
-template <class T>
-inline typename TQueue<T>::TIterator TQueue<T>::begin()
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline typename TQueue<T, Index, Alloc, Growth, Stats, N>::TIterator TQueue<T, Index, Alloc, Growth, Stats, N>::begin()
 {
   return TIterator(*this, head, 0);
 }
 
-template <class T>
-inline typename TQueue<T>::TIterator TQueue<T>::end()
+template <class T, class Index, class Alloc, class Growth, class Stats, size_t N>
+inline typename TQueue<T, Index, Alloc, Growth, Stats, N>::TIterator TQueue<T, Index, Alloc, Growth, Stats, N>::end()
 {
-  return TIterator(*this, (head + count) % capacity, count);
+  return TIterator(*this, tail, count);
 }
 
-template <class I>
-inline istream& operator>>(istream& is, TQueue<I>& queue)
+template <class I, class Idx, class A, class G, class S, size_t M>
+inline istream& operator>>(istream& is, TQueue<I, Idx, A, G, S, M>& queue)
 {
-  queue.head = 0;
-  queue.tail = 0;
-  queue.count = 0;
+  queue.Clear();
 
   size_t n;
   is >> n;
 
-  if (n > queue.capacity)
-    queue.SetCapacity(n);
+  if (!queue.GrowTo(n))
+    throw("Wrong element count");
 
   for (size_t i = 0; i < n; ++i)
   {
     I element;
     is >> element;
-    queue.enqueue(element);
+    queue.enqueue(std::move(element));
   }
 
   return is;
 }
 
-template <class O>
-inline ostream& operator<<(ostream& os, const TQueue<O>& queue)
+template <class O, class Idx, class A, class G, class S, size_t M>
+inline ostream& operator<<(ostream& os, const TQueue<O, Idx, A, G, S, M>& queue)
 {
   os << "[";
   for (size_t i = 0; i < queue.count; ++i)
   {
-    os << queue.memory[(queue.head + i) % queue.capacity];
+    os << queue.memory[Idx::Offset(queue.head, i, queue.capacity)];
     if (i < queue.count - 1)
       os << ", ";
   }
   os << "]";
   return os;
-}
\ No newline at end of file
+}
+
+template <class I, class Idx, class A, class G, class S, size_t M>
+inline istream& ReadBinary(istream& is, TQueue<I, Idx, A, G, S, M>& queue)
+{
+  bool bounded;
+  size_t n = ReadBinaryHeader<I>(is, TBinaryHeader::queueKind, bounded);
+  queue.Clear();
+
+  for (size_t done = 0; done < n;)
+  {
+    size_t batch = ReadBinaryBatch<I>(n - done, bounded);
+    if (!queue.GrowTo(done + batch))
+      throw("Wrong element count");
+
+    if constexpr (TSerializer<I>::bulk)
+    {
+      ReadBinaryBytes(is, queue.memory + done, batch * sizeof(I));
+      queue.count = done + batch;
+      queue.tail = Idx::Offset(0, queue.count, queue.capacity);
+      queue.stats.OnPush(batch, queue.count);
+    }
+    else
+    {
+      for (size_t i = 0; i < batch; ++i)
+        queue.enqueue(TSerializer<I>::Read(is));
+    }
+    done += batch;
+  }
+
+  return is;
+}
+
+template <class O, class Idx, class A, class G, class S, size_t M>
+inline ostream& WriteBinary(ostream& os, const TQueue<O, Idx, A, G, S, M>& queue)
+{
+  WriteBinaryHeader<O>(os, TBinaryHeader::queueKind, queue.count);
+  size_t first = queue.count == 0 ? 0 : Idx::Slot(queue.head, queue.capacity);
+  size_t n = min(queue.count, queue.capacity - first);
+  WriteBinaryRun(os, queue.memory + first, n);
+  WriteBinaryRun(os, queue.memory, queue.count - n);
+  return os;
+}
+
+template <class T, size_t N = 16>
+using TSmallQueue = TQueue<T, TModuloIndex, allocator<T>, TGeometricGrowth, TNoStats, N>;
\ No newline at end of file
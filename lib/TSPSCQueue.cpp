@@ -0,0 +1 @@
+#include "TSPSCQueue.h"
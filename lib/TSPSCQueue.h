@@ -0,0 +1,152 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include "TEventCount.h"
+
+using namespace std;
+
+template <class T>
+class TSPSCQueue
+{
+protected:
+  static constexpr size_t cacheLine = 64;
+
+  size_t capacity;
+  size_t mask;
+  T* memory;
+
+  alignas(cacheLine) atomic<size_t> head;
+  size_t cachedTail;
+
+  alignas(cacheLine) atomic<size_t> tail;
+  size_t cachedHead;
+
+  alignas(cacheLine) TEventCount notEmpty;
+  alignas(cacheLine) TEventCount notFull;
+public:
+  TSPSCQueue(size_t capacity_);
+  TSPSCQueue(const TSPSCQueue& other) = delete;
+  TSPSCQueue& operator=(const TSPSCQueue& other) = delete;
+  ~TSPSCQueue();
+
+  size_t GetCapacity() const;
+
+  size_t Size() const;
+  bool try_enqueue(const T& element);
+  bool try_dequeue(T& element);
+  void enqueue(const T& element);
+  T dequeue();
+  template <class Rep, class Period>
+  bool enqueue_for(const T& element, const chrono::duration<Rep, Period>& timeout);
+  template <class Rep, class Period>
+  bool dequeue_for(T& element, const chrono::duration<Rep, Period>& timeout);
+
+  bool IsEmpty() const;
+  bool IsFull() const;
+};
+
+template <class T>
+inline TSPSCQueue<T>::TSPSCQueue(size_t capacity_) : capacity(bit_ceil(capacity_)), mask(capacity - 1), memory(nullptr), head(0), cachedTail(0), tail(0), cachedHead(0)
+{
+  if (capacity_ == 0)
+    throw("Wrong capacity");
+  memory = new T[capacity];
+}
+
+template <class T>
+inline TSPSCQueue<T>::~TSPSCQueue()
+{
+  delete[] memory;
+}
+
+template <class T>
+inline size_t TSPSCQueue<T>::GetCapacity() const
+{
+  return capacity;
+}
+
+template <class T>
+inline size_t TSPSCQueue<T>::Size() const
+{
+  size_t h = head.load(memory_order_acquire);
+  size_t t = tail.load(memory_order_acquire);
+  return t - h;
+}
+
+template <class T>
+inline bool TSPSCQueue<T>::try_enqueue(const T& element)
+{
+  size_t t = tail.load(memory_order_relaxed);
+  if (t - cachedHead == capacity)
+  {
+    cachedHead = head.load(memory_order_acquire);
+    if (t - cachedHead == capacity)
+      return false;
+  }
+
+  memory[t & mask] = element;
+  tail.store(t + 1, memory_order_release);
+  notEmpty.NotifyOne();
+  return true;
+}
+
+template <class T>
+inline bool TSPSCQueue<T>::try_dequeue(T& element)
+{
+  size_t h = head.load(memory_order_relaxed);
+  if (h == cachedTail)
+  {
+    cachedTail = tail.load(memory_order_acquire);
+    if (h == cachedTail)
+      return false;
+  }
+
+  element = std::move(memory[h & mask]);
+  head.store(h + 1, memory_order_release);
+  notFull.NotifyOne();
+  return true;
+}
+
+template <class T>
+inline void TSPSCQueue<T>::enqueue(const T& element)
+{
+  notFull.Await([&]() { return try_enqueue(element); });
+}
+
+template <class T>
+inline T TSPSCQueue<T>::dequeue()
+{
+  T element;
+  notEmpty.Await([&]() { return try_dequeue(element); });
+  return element;
+}
+
+template <class T>
+template <class Rep, class Period>
+inline bool TSPSCQueue<T>::enqueue_for(const T& element, const chrono::duration<Rep, Period>& timeout)
+{
+  auto deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(timeout);
+  return notFull.AwaitUntil([&]() { return try_enqueue(element); }, deadline);
+}
+
+template <class T>
+template <class Rep, class Period>
+inline bool TSPSCQueue<T>::dequeue_for(T& element, const chrono::duration<Rep, Period>& timeout)
+{
+  auto deadline = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(timeout);
+  return notEmpty.AwaitUntil([&]() { return try_dequeue(element); }, deadline);
+}
+
+template <class T>
+inline bool TSPSCQueue<T>::IsEmpty() const
+{
+  return Size() == 0;
+}
+
+template <class T>
+inline bool TSPSCQueue<T>::IsFull() const
+{
+  return Size() >= capacity;
+}
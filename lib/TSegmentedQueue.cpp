@@ -0,0 +1 @@
+#include "TSegmentedQueue.h"
@@ -0,0 +1,442 @@
+#pragma once
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+using namespace std;
+
+template <class T, size_t N = 256, class Alloc = allocator<T>>
+class TSegmentedQueue
+{
+  static_assert(N > 0, "TSegmentedQueue needs at least one element per chunk");
+protected:
+  struct TChunk
+  {
+    TChunk* next;
+    alignas(T) unsigned char storage[N * sizeof(T)];
+
+    T* Data();
+  };
+
+  using Traits = allocator_traits<Alloc>;
+  using ChunkAlloc = typename Traits::template rebind_alloc<TChunk>;
+  using ChunkTraits = allocator_traits<ChunkAlloc>;
+
+  [[no_unique_address]] Alloc alloc;
+  [[no_unique_address]] ChunkAlloc chunkAlloc;
+  TChunk* head;
+  TChunk* tail;
+  size_t first;
+  size_t last;
+  size_t count;
+  size_t chunks;
+  TChunk* pool;
+  size_t pooled;
+
+  TChunk* AcquireChunk();
+  void ReleaseChunk(TChunk* chunk);
+  void Append();
+public:
+  TSegmentedQueue();
+  explicit TSegmentedQueue(const Alloc& alloc_);
+  TSegmentedQueue(const TSegmentedQueue& other);
+  TSegmentedQueue(TSegmentedQueue&& other);
+  ~TSegmentedQueue();
+
+  Alloc GetAllocator() const;
+  size_t GetChunkSize() const;
+  size_t GetChunks() const;
+  size_t GetPooled() const;
+  size_t GetCapacity() const;
+
+  void reserve(size_t capacity_);
+  void shrink_to_fit();
+
+  size_t Size() const;
+  void enqueue(const T& element);
+  void enqueue(T&& element);
+  template <class... Args>
+  T& emplace(Args&&... args);
+  T dequeue();
+  void Clear();
+
+  T operator[](size_t index) const;
+
+  bool IsEmpty() const;
+
+  class TIterator
+  {
+  protected:
+    TChunk* chunk;
+    size_t cur;
+    size_t prev;
+  public:
+    TIterator(TChunk* chunk_, size_t start, size_t cnt);
+    T& operator*();
+    TIterator& operator++();
+    TIterator operator++(int);
+
+    bool operator==(const TIterator& other) const;
+    bool operator!=(const TIterator& other) const;
+  };
+
+  TIterator begin();
+  TIterator end();
+
+  template <class I, size_t M, class A>
+  friend istream& operator>>(istream& is, TSegmentedQueue<I, M, A>& queue);
+
+  template <class O, size_t M, class A>
+  friend ostream& operator<<(ostream& os, const TSegmentedQueue<O, M, A>& queue);
+};
+
+template <class T, size_t N, class Alloc>
+inline T* TSegmentedQueue<T, N, Alloc>::TChunk::Data()
+{
+  return reinterpret_cast<T*>(storage);
+}
+
+template <class T, size_t N, class Alloc>
+inline typename TSegmentedQueue<T, N, Alloc>::TChunk* TSegmentedQueue<T, N, Alloc>::AcquireChunk()
+{
+  TChunk* chunk = pool;
+  if (chunk != nullptr)
+  {
+    pool = chunk->next;
+    pooled--;
+  }
+  else
+    chunk = ChunkTraits::allocate(chunkAlloc, 1);
+  chunk->next = nullptr;
+  chunks++;
+  return chunk;
+}
+
+template <class T, size_t N, class Alloc>
+inline void TSegmentedQueue<T, N, Alloc>::ReleaseChunk(TChunk* chunk)
+{
+  chunk->next = pool;
+  pool = chunk;
+  pooled++;
+  chunks--;
+}
+
+template <class T, size_t N, class Alloc>
+inline void TSegmentedQueue<T, N, Alloc>::Append()
+{
+  TChunk* chunk = AcquireChunk();
+  if (tail == nullptr)
+  {
+    head = chunk;
+    first = 0;
+  }
+  else
+    tail->next = chunk;
+  tail = chunk;
+  last = 0;
+}
+
+template <class T, size_t N, class Alloc>
+inline TSegmentedQueue<T, N, Alloc>::TSegmentedQueue() : alloc(), chunkAlloc(), head(nullptr), tail(nullptr), first(0), last(0), count(0), chunks(0), pool(nullptr), pooled(0) {}
+
+template <class T, size_t N, class Alloc>
+inline TSegmentedQueue<T, N, Alloc>::TSegmentedQueue(const Alloc& alloc_) : alloc(alloc_), chunkAlloc(alloc_), head(nullptr), tail(nullptr), first(0), last(0), count(0), chunks(0), pool(nullptr), pooled(0) {}
+
+template <class T, size_t N, class Alloc>
+inline TSegmentedQueue<T, N, Alloc>::TSegmentedQueue(const TSegmentedQueue& other) : alloc(Traits::select_on_container_copy_construction(other.alloc)), chunkAlloc(alloc), head(nullptr), tail(nullptr), first(0), last(0), count(0), chunks(0), pool(nullptr), pooled(0)
+{
+  try
+  {
+    TChunk* chunk = other.head;
+    size_t index = other.first;
+    for (size_t i = 0; i < other.count; ++i)
+    {
+      enqueue(chunk->Data()[index]);
+      if (++index == N)
+      {
+        chunk = chunk->next;
+        index = 0;
+      }
+    }
+  }
+  catch (...)
+  {
+    Clear();
+    shrink_to_fit();
+    throw;
+  }
+}
+
+template <class T, size_t N, class Alloc>
+inline TSegmentedQueue<T, N, Alloc>::TSegmentedQueue(TSegmentedQueue&& other) : alloc(std::move(other.alloc)), chunkAlloc(std::move(other.chunkAlloc)), head(other.head), tail(other.tail), first(other.first), last(other.last), count(other.count), chunks(other.chunks), pool(other.pool), pooled(other.pooled)
+{
+  other.head = nullptr;
+  other.tail = nullptr;
+  other.first = 0;
+  other.last = 0;
+  other.count = 0;
+  other.chunks = 0;
+  other.pool = nullptr;
+  other.pooled = 0;
+}
+
+template <class T, size_t N, class Alloc>
+inline TSegmentedQueue<T, N, Alloc>::~TSegmentedQueue()
+{
+  Clear();
+  shrink_to_fit();
+}
+
+template <class T, size_t N, class Alloc>
+inline Alloc TSegmentedQueue<T, N, Alloc>::GetAllocator() const
+{
+  return alloc;
+}
+
+template <class T, size_t N, class Alloc>
+inline size_t TSegmentedQueue<T, N, Alloc>::GetChunkSize() const
+{
+  return N;
+}
+
+template <class T, size_t N, class Alloc>
+inline size_t TSegmentedQueue<T, N, Alloc>::GetChunks() const
+{
+  return chunks;
+}
+
+template <class T, size_t N, class Alloc>
+inline size_t TSegmentedQueue<T, N, Alloc>::GetPooled() const
+{
+  return pooled;
+}
+
+template <class T, size_t N, class Alloc>
+inline size_t TSegmentedQueue<T, N, Alloc>::GetCapacity() const
+{
+  return (chunks + pooled) * N;
+}
+
+template <class T, size_t N, class Alloc>
+inline void TSegmentedQueue<T, N, Alloc>::reserve(size_t capacity_)
+{
+  while (GetCapacity() < capacity_)
+  {
+    TChunk* chunk = ChunkTraits::allocate(chunkAlloc, 1);
+    chunk->next = pool;
+    pool = chunk;
+    pooled++;
+  }
+}
+
+template <class T, size_t N, class Alloc>
+inline void TSegmentedQueue<T, N, Alloc>::shrink_to_fit()
+{
+  while (pool != nullptr)
+  {
+    TChunk* next = pool->next;
+    ChunkTraits::deallocate(chunkAlloc, pool, 1);
+    pool = next;
+  }
+  pooled = 0;
+}
+
+template <class T, size_t N, class Alloc>
+inline size_t TSegmentedQueue<T, N, Alloc>::Size() const
+{
+  return count;
+}
+
+template <class T, size_t N, class Alloc>
+inline void TSegmentedQueue<T, N, Alloc>::enqueue(const T& element)
+{
+  emplace(element);
+}
+
+template <class T, size_t N, class Alloc>
+inline void TSegmentedQueue<T, N, Alloc>::enqueue(T&& element)
+{
+  emplace(std::move(element));
+}
+
+template <class T, size_t N, class Alloc>
+template <class... Args>
+inline T& TSegmentedQueue<T, N, Alloc>::emplace(Args&&... args)
+{
+  if (tail == nullptr || last == N)
+    Append();
+
+  T* slot = tail->Data() + last;
+  Traits::construct(alloc, slot, std::forward<Args>(args)...);
+  last++;
+  count++;
+  return *slot;
+}
+
+template <class T, size_t N, class Alloc>
+inline T TSegmentedQueue<T, N, Alloc>::dequeue()
+{
+  if (IsEmpty())
+    throw("Empty queue");
+
+  T* slot = head->Data() + first;
+  T element = std::move(*slot);
+  Traits::destroy(alloc, slot);
+  first++;
+  count--;
+
+  if (count == 0)
+  {
+    first = 0;
+    last = 0;
+  }
+  else if (first == N)
+  {
+    TChunk* next = head->next;
+    ReleaseChunk(head);
+    head = next;
+    first = 0;
+  }
+  return element;
+}
+
+template <class T, size_t N, class Alloc>
+inline void TSegmentedQueue<T, N, Alloc>::Clear()
+{
+  TChunk* chunk = head;
+  size_t index = first;
+  for (size_t i = 0; i < count; ++i)
+  {
+    Traits::destroy(alloc, chunk->Data() + index);
+    if (++index == N)
+    {
+      chunk = chunk->next;
+      index = 0;
+    }
+  }
+
+  while (head != nullptr)
+  {
+    TChunk* next = head->next;
+    ReleaseChunk(head);
+    head = next;
+  }
+  tail = nullptr;
+  first = 0;
+  last = 0;
+  count = 0;
+}
+
+template <class T, size_t N, class Alloc>
+inline T TSegmentedQueue<T, N, Alloc>::operator[](size_t index) const
+{
+  if (index >= count)
+    throw("Index out of range");
+
+  size_t offset = first + index;
+  TChunk* chunk = head;
+  for (size_t i = offset / N; i > 0; --i)
+    chunk = chunk->next;
+  return chunk->Data()[offset % N];
+}
+
+template <class T, size_t N, class Alloc>
+inline bool TSegmentedQueue<T, N, Alloc>::IsEmpty() const
+{
+  return count == 0;
+}
+
+template <class T, size_t N, class Alloc>
+inline TSegmentedQueue<T, N, Alloc>::TIterator::TIterator(TChunk* chunk_, size_t start, size_t cnt) : chunk(chunk_), cur(start), prev(cnt) {}
+
+template <class T, size_t N, class Alloc>
+inline T& TSegmentedQueue<T, N, Alloc>::TIterator::operator*()
+{
+  return chunk->Data()[cur];
+}
+
+template <class T, size_t N, class Alloc>
+inline typename TSegmentedQueue<T, N, Alloc>::TIterator& TSegmentedQueue<T, N, Alloc>::TIterator::operator++()
+{
+  if (++cur == N)
+  {
+    chunk = chunk->next;
+    cur = 0;
+  }
+  prev++;
+  return *this;
+}
+
+template <class T, size_t N, class Alloc>
+inline typename TSegmentedQueue<T, N, Alloc>::TIterator TSegmentedQueue<T, N, Alloc>::TIterator::operator++(int)
+{
+  TIterator temp = *this;
+  ++(*this);
+  return temp;
+}
+
+template <class T, size_t N, class Alloc>
+inline bool TSegmentedQueue<T, N, Alloc>::TIterator::operator==(const TIterator& other) const
+{
+  return prev == other.prev;
+}
+
+template <class T, size_t N, class Alloc>
+inline bool TSegmentedQueue<T, N, Alloc>::TIterator::operator!=(const TIterator& other) const
+{
+  return !(*this == other);
+}
+
+template <class T, size_t N, class Alloc>
+inline typename TSegmentedQueue<T, N, Alloc>::TIterator TSegmentedQueue<T, N, Alloc>::begin()
+{
+  return TIterator(head, first, 0);
+}
+
+template <class T, size_t N, class Alloc>
+inline typename TSegmentedQueue<T, N, Alloc>::TIterator TSegmentedQueue<T, N, Alloc>::end()
+{
+  return TIterator(nullptr, 0, count);
+}
+
+template <class I, size_t M, class A>
+inline istream& operator>>(istream& is, TSegmentedQueue<I, M, A>& queue)
+{
+  queue.Clear();
+
+  size_t n;
+  is >> n;
+  queue.reserve(n);
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    I element;
+    is >> element;
+    queue.enqueue(std::move(element));
+  }
+
+  return is;
+}
+
+template <class O, size_t M, class A>
+inline ostream& operator<<(ostream& os, const TSegmentedQueue<O, M, A>& queue)
+{
+  os << "[";
+  auto* chunk = queue.head;
+  size_t index = queue.first;
+  for (size_t i = 0; i < queue.count; ++i)
+  {
+    os << chunk->Data()[index];
+    if (i < queue.count - 1)
+      os << ", ";
+    if (++index == M)
+    {
+      chunk = chunk->next;
+      index = 0;
+    }
+  }
+  os << "]";
+  return os;
+}
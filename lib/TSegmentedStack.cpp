@@ -0,0 +1 @@
+#include "TSegmentedStack.h"
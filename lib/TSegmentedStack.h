@@ -0,0 +1,339 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+
+using namespace std;
+
+template <class T, size_t B = 16, class Alloc = allocator<T>>
+class TSegmentedStack
+{
+  static_assert(B > 0 && has_single_bit(B), "TSegmentedStack needs a power-of-two first block");
+protected:
+  using Traits = allocator_traits<Alloc>;
+
+  static constexpr size_t maxBlocks = 48;
+
+  [[no_unique_address]] Alloc alloc;
+  size_t count;
+  size_t blockCount;
+  T* blocks[maxBlocks];
+
+  static size_t BlockSize(size_t block);
+  static size_t Block(size_t index);
+  static size_t Offset(size_t index, size_t block);
+  T* Address(size_t index) const;
+  void TrimTo(size_t blocks_);
+public:
+  TSegmentedStack();
+  explicit TSegmentedStack(const Alloc& alloc_);
+  TSegmentedStack(const TSegmentedStack& other);
+  TSegmentedStack(TSegmentedStack&& other);
+  ~TSegmentedStack();
+
+  Alloc GetAllocator() const;
+  size_t GetCapacity() const;
+  size_t GetBlocks() const;
+
+  void shrink_to_fit();
+
+  size_t Size() const;
+  void push(const T& element);
+  void push(T&& element);
+  template <class... Args>
+  T& emplace(Args&&... args);
+  T pop();
+  void Clear();
+
+  T& operator[](size_t index);
+  const T& operator[](size_t index) const;
+
+  bool IsEmpty() const;
+
+  class TIterator
+  {
+  protected:
+    TSegmentedStack& p;
+    size_t cur;
+  public:
+    TIterator(TSegmentedStack& stack, size_t start);
+    T& operator*();
+    TIterator& operator++();
+    TIterator operator++(int);
+
+    bool operator==(const TIterator& other) const;
+    bool operator!=(const TIterator& other) const;
+  };
+
+  TIterator begin();
+  TIterator end();
+
+  template <class I, size_t C, class A>
+  friend istream& operator>>(istream& is, TSegmentedStack<I, C, A>& stack);
+
+  template <class O, size_t C, class A>
+  friend ostream& operator<<(ostream& os, const TSegmentedStack<O, C, A>& stack);
+};
+
+template <class T, size_t B, class Alloc>
+inline size_t TSegmentedStack<T, B, Alloc>::BlockSize(size_t block)
+{
+  return B << block;
+}
+
+template <class T, size_t B, class Alloc>
+inline size_t TSegmentedStack<T, B, Alloc>::Block(size_t index)
+{
+  return bit_width(index / B + 1) - 1;
+}
+
+template <class T, size_t B, class Alloc>
+inline size_t TSegmentedStack<T, B, Alloc>::Offset(size_t index, size_t block)
+{
+  return index - (BlockSize(block) - B);
+}
+
+template <class T, size_t B, class Alloc>
+inline T* TSegmentedStack<T, B, Alloc>::Address(size_t index) const
+{
+  size_t block = Block(index);
+  return blocks[block] + Offset(index, block);
+}
+
+template <class T, size_t B, class Alloc>
+inline void TSegmentedStack<T, B, Alloc>::TrimTo(size_t blocks_)
+{
+  for (; blockCount > blocks_; --blockCount)
+    Traits::deallocate(alloc, blocks[blockCount - 1], BlockSize(blockCount - 1));
+}
+
+template <class T, size_t B, class Alloc>
+inline TSegmentedStack<T, B, Alloc>::TSegmentedStack() : alloc(), count(0), blockCount(0) {}
+
+template <class T, size_t B, class Alloc>
+inline TSegmentedStack<T, B, Alloc>::TSegmentedStack(const Alloc& alloc_) : alloc(alloc_), count(0), blockCount(0) {}
+
+template <class T, size_t B, class Alloc>
+inline TSegmentedStack<T, B, Alloc>::TSegmentedStack(const TSegmentedStack& other) : alloc(Traits::select_on_container_copy_construction(other.alloc)), count(0), blockCount(0)
+{
+  try
+  {
+    for (size_t i = 0; i < other.count; ++i)
+      push(*other.Address(i));
+  }
+  catch (...)
+  {
+    Clear();
+    TrimTo(0);
+    throw;
+  }
+}
+
+template <class T, size_t B, class Alloc>
+inline TSegmentedStack<T, B, Alloc>::TSegmentedStack(TSegmentedStack&& other) : alloc(std::move(other.alloc)), count(other.count), blockCount(other.blockCount)
+{
+  for (size_t i = 0; i < blockCount; ++i)
+    blocks[i] = other.blocks[i];
+  other.count = 0;
+  other.blockCount = 0;
+}
+
+template <class T, size_t B, class Alloc>
+inline TSegmentedStack<T, B, Alloc>::~TSegmentedStack()
+{
+  Clear();
+  TrimTo(0);
+}
+
+template <class T, size_t B, class Alloc>
+inline Alloc TSegmentedStack<T, B, Alloc>::GetAllocator() const
+{
+  return alloc;
+}
+
+template <class T, size_t B, class Alloc>
+inline size_t TSegmentedStack<T, B, Alloc>::GetCapacity() const
+{
+  return BlockSize(blockCount) - B;
+}
+
+template <class T, size_t B, class Alloc>
+inline size_t TSegmentedStack<T, B, Alloc>::GetBlocks() const
+{
+  return blockCount;
+}
+
+template <class T, size_t B, class Alloc>
+inline void TSegmentedStack<T, B, Alloc>::shrink_to_fit()
+{
+  TrimTo(count == 0 ? 0 : Block(count - 1) + 1);
+}
+
+template <class T, size_t B, class Alloc>
+inline size_t TSegmentedStack<T, B, Alloc>::Size() const
+{
+  return count;
+}
+
+template <class T, size_t B, class Alloc>
+inline void TSegmentedStack<T, B, Alloc>::push(const T& element)
+{
+  emplace(element);
+}
+
+template <class T, size_t B, class Alloc>
+inline void TSegmentedStack<T, B, Alloc>::push(T&& element)
+{
+  emplace(std::move(element));
+}
+
+template <class T, size_t B, class Alloc>
+template <class... Args>
+inline T& TSegmentedStack<T, B, Alloc>::emplace(Args&&... args)
+{
+  size_t block = Block(count);
+  if (block == blockCount)
+  {
+    if (block == maxBlocks)
+      throw("Full stack");
+    blocks[block] = Traits::allocate(alloc, BlockSize(block));
+    blockCount++;
+  }
+
+  T* slot = blocks[block] + Offset(count, block);
+  Traits::construct(alloc, slot, std::forward<Args>(args)...);
+  count++;
+  return *slot;
+}
+
+template <class T, size_t B, class Alloc>
+inline T TSegmentedStack<T, B, Alloc>::pop()
+{
+  if (IsEmpty())
+    throw("Empty stack");
+
+  size_t block = Block(count - 1);
+  T* slot = blocks[block] + Offset(count - 1, block);
+  T element = std::move(*slot);
+  Traits::destroy(alloc, slot);
+  count--;
+
+  if (Offset(count, block) == 0)
+    TrimTo(block + 1);
+  return element;
+}
+
+template <class T, size_t B, class Alloc>
+inline void TSegmentedStack<T, B, Alloc>::Clear()
+{
+  if constexpr (!is_trivially_destructible_v<T>)
+  {
+    for (size_t i = 0; i < count; ++i)
+      Traits::destroy(alloc, Address(i));
+  }
+  count = 0;
+  TrimTo(min(blockCount, (size_t)1));
+}
+
+template <class T, size_t B, class Alloc>
+inline T& TSegmentedStack<T, B, Alloc>::operator[](size_t index)
+{
+  if (index >= count)
+    throw("Index out of range");
+  return *Address(index);
+}
+
+template <class T, size_t B, class Alloc>
+inline const T& TSegmentedStack<T, B, Alloc>::operator[](size_t index) const
+{
+  if (index >= count)
+    throw("Index out of range");
+  return *Address(index);
+}
+
+template <class T, size_t B, class Alloc>
+inline bool TSegmentedStack<T, B, Alloc>::IsEmpty() const
+{
+  return count == 0;
+}
+
+template <class T, size_t B, class Alloc>
+inline TSegmentedStack<T, B, Alloc>::TIterator::TIterator(TSegmentedStack& stack, size_t start) : p(stack), cur(start) {}
+
+template <class T, size_t B, class Alloc>
+inline T& TSegmentedStack<T, B, Alloc>::TIterator::operator*()
+{
+  return *p.Address(cur);
+}
+
+template <class T, size_t B, class Alloc>
+inline typename TSegmentedStack<T, B, Alloc>::TIterator& TSegmentedStack<T, B, Alloc>::TIterator::operator++()
+{
+  cur++;
+  return *this;
+}
+
+template <class T, size_t B, class Alloc>
+inline typename TSegmentedStack<T, B, Alloc>::TIterator TSegmentedStack<T, B, Alloc>::TIterator::operator++(int)
+{
+  TIterator temp = *this;
+  ++(*this);
+  return temp;
+}
+
+template <class T, size_t B, class Alloc>
+inline bool TSegmentedStack<T, B, Alloc>::TIterator::operator==(const TIterator& other) const
+{
+  return &p == &other.p && cur == other.cur;
+}
+
+template <class T, size_t B, class Alloc>
+inline bool TSegmentedStack<T, B, Alloc>::TIterator::operator!=(const TIterator& other) const
+{
+  return !(*this == other);
+}
+
+template <class T, size_t B, class Alloc>
+inline typename TSegmentedStack<T, B, Alloc>::TIterator TSegmentedStack<T, B, Alloc>::begin()
+{
+  return TIterator(*this, 0);
+}
+
+template <class T, size_t B, class Alloc>
+inline typename TSegmentedStack<T, B, Alloc>::TIterator TSegmentedStack<T, B, Alloc>::end()
+{
+  return TIterator(*this, count);
+}
+
+template <class I, size_t C, class A>
+inline istream& operator>>(istream& is, TSegmentedStack<I, C, A>& stack)
+{
+  stack.Clear();
+  size_t n;
+  is >> n;
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    I element;
+    is >> element;
+    stack.push(std::move(element));
+  }
+
+  return is;
+}
+
+template <class O, size_t C, class A>
+inline ostream& operator<<(ostream& os, const TSegmentedStack<O, C, A>& stack)
+{
+  os << "[";
+  for (size_t i = 0; i < stack.count; ++i)
+  {
+    os << *stack.Address(i);
+    if (i < stack.count - 1)
+      os << ", ";
+  }
+  os << "]";
+  return os;
+}
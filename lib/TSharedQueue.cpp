@@ -0,0 +1 @@
+#include "TSharedQueue.h"
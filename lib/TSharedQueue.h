@@ -0,0 +1,251 @@
+#pragma once
+#if __has_include(<sys/mman.h>)
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+template <class T, bool multiProducer = true>
+class TSharedQueue
+{
+  static_assert(is_trivially_copyable_v<T>, "TSharedQueue requires a trivially copyable element type");
+  static_assert(atomic<uint64_t>::is_always_lock_free, "TSharedQueue requires lock-free 64-bit atomics");
+protected:
+  static constexpr size_t cacheLine = 64;
+  static constexpr uint32_t magic = 0x51485354;
+
+  struct THeader
+  {
+    atomic<uint32_t> tag;
+    uint32_t elementSize;
+    uint64_t capacity;
+    uint64_t cells;
+
+    alignas(cacheLine) atomic<uint64_t> tail;
+    alignas(cacheLine) atomic<uint64_t> head;
+  };
+
+  struct TCell
+  {
+    atomic<uint64_t> sequence;
+    T data;
+  };
+
+  string name;
+  bool owner;
+  size_t size;
+  char* base;
+  THeader* header;
+  TCell* memory;
+  size_t capacity;
+  size_t mask;
+
+  void Map(int fd);
+public:
+  TSharedQueue(const string& name_, size_t capacity_);
+  explicit TSharedQueue(const string& name_);
+  TSharedQueue(const TSharedQueue& other) = delete;
+  TSharedQueue& operator=(const TSharedQueue& other) = delete;
+  ~TSharedQueue();
+
+  const string& GetName() const;
+  size_t GetCapacity() const;
+
+  size_t Size() const;
+  bool enqueue(const T& element);
+  bool dequeue(T& element);
+
+  bool IsEmpty() const;
+  bool IsFull() const;
+  bool IsOwner() const;
+
+  static void Remove(const string& name_);
+};
+
+template <class T, bool multiProducer>
+inline void TSharedQueue<T, multiProducer>::Map(int fd)
+{
+  void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED)
+    throw("Cannot map segment");
+  base = static_cast<char*>(p);
+  header = reinterpret_cast<THeader*>(base);
+}
+
+template <class T, bool multiProducer>
+inline TSharedQueue<T, multiProducer>::TSharedQueue(const string& name_, size_t capacity_) : name(name_), owner(true), size(0), base(nullptr), header(nullptr), memory(nullptr), capacity(bit_ceil(capacity_)), mask(capacity - 1)
+{
+  if (capacity_ < 2)
+    throw("Wrong capacity");
+
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0)
+    throw("Cannot create segment");
+
+  size_t cells = (sizeof(THeader) + cacheLine - 1) / cacheLine * cacheLine;
+  size = cells + capacity * sizeof(TCell);
+  if (ftruncate(fd, size) != 0)
+  {
+    close(fd);
+    shm_unlink(name.c_str());
+    throw("Cannot create segment");
+  }
+  try
+  {
+    Map(fd);
+  }
+  catch (...)
+  {
+    shm_unlink(name.c_str());
+    throw;
+  }
+
+  new (header) THeader();
+  header->elementSize = sizeof(T);
+  header->capacity = capacity;
+  header->cells = cells;
+  memory = reinterpret_cast<TCell*>(base + cells);
+  for (size_t i = 0; i < capacity; ++i)
+    new (&memory[i].sequence) atomic<uint64_t>(i);
+  header->tag.store(magic, memory_order_release);
+}
+
+template <class T, bool multiProducer>
+inline TSharedQueue<T, multiProducer>::TSharedQueue(const string& name_) : name(name_), owner(false), size(0), base(nullptr), header(nullptr), memory(nullptr), capacity(0), mask(0)
+{
+  int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd < 0)
+    throw("Cannot open segment");
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(THeader))
+  {
+    close(fd);
+    throw("Wrong segment");
+  }
+  size = st.st_size;
+  Map(fd);
+
+  uint64_t cells = header->cells;
+  uint64_t capacity_ = header->capacity;
+  if (header->tag.load(memory_order_acquire) != magic || header->elementSize != sizeof(T) || cells < sizeof(THeader) || cells % alignof(TCell) != 0 || cells > size
+    || capacity_ == 0 || !has_single_bit(capacity_) || capacity_ > (size - cells) / sizeof(TCell))
+  {
+    munmap(base, size);
+    throw("Wrong segment");
+  }
+  capacity = capacity_;
+  mask = capacity - 1;
+  memory = reinterpret_cast<TCell*>(base + cells);
+}
+
+template <class T, bool multiProducer>
+inline TSharedQueue<T, multiProducer>::~TSharedQueue()
+{
+  munmap(base, size);
+  if (owner)
+    shm_unlink(name.c_str());
+}
+
+template <class T, bool multiProducer>
+inline const string& TSharedQueue<T, multiProducer>::GetName() const
+{
+  return name;
+}
+
+template <class T, bool multiProducer>
+inline size_t TSharedQueue<T, multiProducer>::GetCapacity() const
+{
+  return capacity;
+}
+
+template <class T, bool multiProducer>
+inline size_t TSharedQueue<T, multiProducer>::Size() const
+{
+  uint64_t h = header->head.load(memory_order_acquire);
+  uint64_t t = header->tail.load(memory_order_acquire);
+  return t > h ? t - h : 0;
+}
+
+template <class T, bool multiProducer>
+inline bool TSharedQueue<T, multiProducer>::enqueue(const T& element)
+{
+  uint64_t pos = header->tail.load(memory_order_relaxed);
+  TCell* cell;
+  while (true)
+  {
+    cell = &memory[pos & mask];
+    uint64_t seq = cell->sequence.load(memory_order_acquire);
+    int64_t diff = (int64_t)seq - (int64_t)pos;
+    if (diff == 0)
+    {
+      if constexpr (multiProducer)
+      {
+        if (header->tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+          break;
+      }
+      else
+      {
+        header->tail.store(pos + 1, memory_order_relaxed);
+        break;
+      }
+    }
+    else if (diff < 0)
+      return false;
+    else
+      pos = header->tail.load(memory_order_relaxed);
+  }
+
+  cell->data = element;
+  cell->sequence.store(pos + 1, memory_order_release);
+  return true;
+}
+
+template <class T, bool multiProducer>
+inline bool TSharedQueue<T, multiProducer>::dequeue(T& element)
+{
+  uint64_t pos = header->head.load(memory_order_relaxed);
+  TCell* cell = &memory[pos & mask];
+  if (cell->sequence.load(memory_order_acquire) != pos + 1)
+    return false;
+
+  element = cell->data;
+  cell->sequence.store(pos + capacity, memory_order_release);
+  header->head.store(pos + 1, memory_order_release);
+  return true;
+}
+
+template <class T, bool multiProducer>
+inline bool TSharedQueue<T, multiProducer>::IsEmpty() const
+{
+  return Size() == 0;
+}
+
+template <class T, bool multiProducer>
+inline bool TSharedQueue<T, multiProducer>::IsFull() const
+{
+  return Size() >= capacity;
+}
+
+template <class T, bool multiProducer>
+inline bool TSharedQueue<T, multiProducer>::IsOwner() const
+{
+  return owner;
+}
+
+template <class T, bool multiProducer>
+inline void TSharedQueue<T, multiProducer>::Remove(const string& name_)
+{
+  shm_unlink(name_.c_str());
+}
+#endif
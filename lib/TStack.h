@@ -1,23 +1,51 @@
 #pragma once
 #include <cstddef>
+#include <cstring>
+#include <iterator>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include "TBinary.h"
+#include "TGrowth.h"
+#include "TInlineBuffer.h"
+#include "TStats.h"
 
 using namespace std;
 
-template <class T>
+template <class T, class Alloc = allocator<T>, class Growth = TGeometricGrowth, class Stats = TNoStats, size_t N = 0>
 class TStack
 {
 protected:
+  using Traits = allocator_traits<Alloc>;
+
+  [[no_unique_address]] Alloc alloc;
+  [[no_unique_address]] Growth growth;
+  [[no_unique_address]] Stats stats;
   size_t capacity;
-  size_t top;
+  size_t count;
   T* memory;
+  [[no_unique_address]] TInlineBuffer<T, N> buffer;
+
+  T* Allocate(size_t capacity_);
+  void Deallocate(T* memory_, size_t capacity_);
+  size_t NextCapacity() const;
+  bool CanGrow() const;
+  bool GrowTo(size_t required);
+  void Relocate(T* newMem);
+  void Clear();
 public:
   TStack();
-  TStack(size_t capacity_);
+  explicit TStack(const Alloc& alloc_);
+  TStack(size_t capacity_, const Alloc& alloc_ = Alloc());
   TStack(const TStack& other);
   TStack(TStack&& other);
   ~TStack();
 
+  Alloc GetAllocator() const;
+  Growth GetGrowth() const;
+  const Stats& GetStats() const;
   size_t GetCapacity() const;
   size_t GetTop() const;
   T* GetMemory() const;
@@ -25,13 +53,35 @@ public:
   void SetCapacity(size_t capacity_);
   void SetTop(size_t top_);
   void SetMemory(T* memory_);
+  void SetGrowth(const Growth& growth_);
+  void ResetStats();
+
+  void reserve(size_t capacity_);
+  void shrink_to_fit();
 
   size_t Size() const;
   void push(const T& element);
+  void push(T&& element);
+  template <class... Args>
+  T& emplace(Args&&... args);
   T pop();
 
-  bool operator==(const TStack<T>& other) const;
-  bool operator!=(const TStack<T>& other) const;
+  bool try_push(const T& element);
+  bool try_push(T&& element);
+  bool try_pop(T& element) noexcept(is_nothrow_move_assignable_v<T>);
+  optional<T> try_pop() noexcept(is_nothrow_move_constructible_v<T>);
+  T& top() noexcept;
+  const T& top() const noexcept;
+
+  template <class InputIt>
+  size_t push_range(InputIt first, InputIt last);
+  size_t push_range(span<const T> elements);
+  template <class OutputIt>
+  size_t pop_range(OutputIt out, size_t n);
+  size_t pop_range(span<T> out);
+
+  bool operator==(const TStack& other) const;
+  bool operator!=(const TStack& other) const;
   T operator[](size_t index) const;
 
   bool IsEmpty() const;
@@ -40,11 +90,11 @@ public:
   class TIterator
   {
   protected:
-    TStack<T>& p;
+    TStack& p;
     size_t cur;
     size_t prev;
   public:
-    TIterator(TStack<T> &stack, size_t start, size_t cnt);
+    TIterator(TStack& stack, size_t start, size_t cnt);
     T& operator*();
     TIterator& operator++();
     TIterator operator++(int);
@@ -56,137 +106,469 @@ public:
   TIterator begin();
   TIterator end();
 
-  template <class I>
-  friend istream& operator>>(istream& is, TStack<I>& stack);
+  template <class I, class A, class G, class S, size_t M>
+  friend istream& operator>>(istream& is, TStack<I, A, G, S, M>& stack);
+
+  template <class O, class A, class G, class S, size_t M>
+  friend ostream& operator<<(ostream& os, const TStack<O, A, G, S, M>& stack);
 
-  template <class O>
-  friend ostream& operator<<(ostream& os, const TStack<O>& stack);
+  template <class I, class A, class G, class S, size_t M>
+  friend istream& ReadBinary(istream& is, TStack<I, A, G, S, M>& stack);
+
+  template <class O, class A, class G, class S, size_t M>
+  friend ostream& WriteBinary(ostream& os, const TStack<O, A, G, S, M>& stack);
 };
 
-template <class T>
-inline TStack<T>::TStack() : capacity(0), top(0), memory(new T[capacity]) {}
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline T* TStack<T, Alloc, Growth, Stats, N>::Allocate(size_t capacity_)
+{
+  if (capacity_ <= N)
+    return buffer.Data();
+  return Traits::allocate(alloc, capacity_);
+}
 
-template <class T>
-inline TStack<T>::TStack(size_t capacity_) : capacity(capacity_), top(0), memory(new T[capacity]) {}
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline void TStack<T, Alloc, Growth, Stats, N>::Deallocate(T* memory_, size_t capacity_)
+{
+  if (memory_ != nullptr && memory_ != buffer.Data())
+    Traits::deallocate(alloc, memory_, capacity_);
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline size_t TStack<T, Alloc, Growth, Stats, N>::NextCapacity() const
+{
+  size_t newCap = growth.Next(capacity, capacity + 1);
+  if (newCap <= capacity)
+    throw("Full stack");
+  return newCap;
+}
 
-template <class T>
-inline TStack<T>::TStack(const TStack& other) : capacity(other.capacity), top(other.top), memory(new T[capacity])
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline bool TStack<T, Alloc, Growth, Stats, N>::CanGrow() const
 {
-  for (size_t i = 0; i < top; ++i)
-    memory[i] = other.memory[i];
+  return growth.Next(capacity, capacity + 1) > capacity;
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline bool TStack<T, Alloc, Growth, Stats, N>::GrowTo(size_t required)
+{
+  if (required <= capacity)
+    return true;
+
+  size_t newCap = growth.Next(capacity, required);
+  if (newCap < required)
+    return false;
+  SetCapacity(newCap);
+  return true;
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline void TStack<T, Alloc, Growth, Stats, N>::Relocate(T* newMem)
+{
+  stats.OnResize(count * sizeof(T));
+  if constexpr (is_trivially_copyable_v<T>)
+  {
+    if (count != 0)
+      memcpy(newMem, memory, count * sizeof(T));
+  }
+  else
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      Traits::construct(alloc, newMem + i, std::move(memory[i]));
+      Traits::destroy(alloc, memory + i);
+    }
+  }
 }
 
-template <class T>
-inline TStack<T>::TStack(TStack&& other) : capacity(other.capacity), top(other.top), memory(other.memory)
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline void TStack<T, Alloc, Growth, Stats, N>::Clear()
 {
-  other.memory = nullptr;
-  other.capacity = 0;
-  other.top = 0;
+  if constexpr (!is_trivially_destructible_v<T>)
+  {
+    for (size_t i = 0; i < count; ++i)
+      Traits::destroy(alloc, memory + i);
+  }
+  count = 0;
 }
 
-template <class T>
-inline TStack<T>::~TStack()
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline TStack<T, Alloc, Growth, Stats, N>::TStack() : alloc(), capacity(N), count(0), memory(Allocate(N)) {}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline TStack<T, Alloc, Growth, Stats, N>::TStack(const Alloc& alloc_) : alloc(alloc_), capacity(N), count(0), memory(Allocate(N)) {}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline TStack<T, Alloc, Growth, Stats, N>::TStack(size_t capacity_, const Alloc& alloc_) : alloc(alloc_), capacity(max(capacity_, N)), count(0), memory(Allocate(capacity)) {}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline TStack<T, Alloc, Growth, Stats, N>::TStack(const TStack& other) : alloc(Traits::select_on_container_copy_construction(other.alloc)), growth(other.growth), capacity(other.capacity), count(0), memory(Allocate(capacity))
 {
-  delete[] memory;
+  if constexpr (is_trivially_copyable_v<T>)
+  {
+    if (other.count != 0)
+      memcpy(memory, other.memory, other.count * sizeof(T));
+    count = other.count;
+    return;
+  }
+
+  try
+  {
+    for (; count < other.count; ++count)
+      Traits::construct(alloc, memory + count, other.memory[count]);
+  }
+  catch (...)
+  {
+    Clear();
+    Deallocate(memory, capacity);
+    throw;
+  }
 }
 
-template <class T>
-inline size_t TStack<T>::GetCapacity() const
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline TStack<T, Alloc, Growth, Stats, N>::TStack(TStack&& other) : alloc(std::move(other.alloc)), growth(other.growth), stats(std::move(other.stats)), capacity(other.capacity), count(other.count), memory(other.memory)
+{
+  if (other.memory == other.buffer.Data() && N != 0)
+  {
+    memory = buffer.Data();
+    other.Relocate(memory);
+  }
+  other.memory = other.buffer.Data();
+  other.capacity = N;
+  other.count = 0;
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline TStack<T, Alloc, Growth, Stats, N>::~TStack()
+{
+  Clear();
+  Deallocate(memory, capacity);
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline Alloc TStack<T, Alloc, Growth, Stats, N>::GetAllocator() const
+{
+  return alloc;
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline Growth TStack<T, Alloc, Growth, Stats, N>::GetGrowth() const
+{
+  return growth;
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline const Stats& TStack<T, Alloc, Growth, Stats, N>::GetStats() const
+{
+  return stats;
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline void TStack<T, Alloc, Growth, Stats, N>::ResetStats()
+{
+  stats = Stats();
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline size_t TStack<T, Alloc, Growth, Stats, N>::GetCapacity() const
 {
   return capacity;
 }
 
-template <class T>
-inline size_t TStack<T>::GetTop() const
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline size_t TStack<T, Alloc, Growth, Stats, N>::GetTop() const
 {
-  return top;
+  return count;
 }
 
-template <class T>
-inline T* TStack<T>::GetMemory() const
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline T* TStack<T, Alloc, Growth, Stats, N>::GetMemory() const
 {
   return memory;
 }
 
-template <class T>
-inline void TStack<T>::SetCapacity(size_t capacity_)
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline void TStack<T, Alloc, Growth, Stats, N>::SetCapacity(size_t capacity_)
 {
-  if (capacity_ < top)
+  capacity_ = max(capacity_, N);
+  if (capacity_ < count)
     throw("Wrong capacity");
+  if (capacity_ == capacity && memory == buffer.Data())
+    return;
 
-  T* newMem = new T[capacity_];
-  for (size_t i = 0; i < top; ++i)
-    newMem[i] = memory[i];
+  T* newMem = Allocate(capacity_);
+  Relocate(newMem);
 
-  delete[] memory;
+  Deallocate(memory, capacity);
   memory = newMem;
   capacity = capacity_;
 }
 
-template <class T>
-inline void TStack<T>::SetTop(size_t top_)
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline void TStack<T, Alloc, Growth, Stats, N>::SetTop(size_t top_)
 {
   if (top_ > capacity)
     throw("Wrong top");
-  top = top_;
+
+  for (; count > top_; --count)
+    Traits::destroy(alloc, memory + count - 1);
+  for (; count < top_; ++count)
+    Traits::construct(alloc, memory + count);
 }
 
-template <class T>
-inline void TStack<T>::SetMemory(T* memory_)
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline void TStack<T, Alloc, Growth, Stats, N>::SetMemory(T* memory_)
 {
-  delete[] memory;
+  size_t count_ = count;
+  Clear();
+  Deallocate(memory, capacity);
   memory = memory_;
+  count = count_;
 }
 
-template <class T>
-inline size_t TStack<T>::Size() const
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline void TStack<T, Alloc, Growth, Stats, N>::SetGrowth(const Growth& growth_)
 {
-  return top;
+  growth = growth_;
 }
 
-template <class T>
-inline void TStack<T>::push(const T& element)
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline void TStack<T, Alloc, Growth, Stats, N>::reserve(size_t capacity_)
 {
-  if (IsFull()) 
-  {
-    if (capacity == 0) 
-    {
-      capacity = 10;
-      memory = new T[capacity];
-    } 
-    else 
-    {
-      size_t newCap = capacity * 2;
-      T* newMem = new T[newCap];
+  if (capacity_ <= capacity)
+    return;
+  if (capacity_ > growth.Limit())
+    throw("Wrong capacity");
+  SetCapacity(capacity_);
+}
 
-      for (size_t i = 0; i < top; ++i)
-        newMem[i] = memory[i];
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline void TStack<T, Alloc, Growth, Stats, N>::shrink_to_fit()
+{
+  if (capacity != count)
+    SetCapacity(count);
+}
 
-      delete[] memory;
-      memory = newMem;
-      capacity = newCap;
-    }
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline size_t TStack<T, Alloc, Growth, Stats, N>::Size() const
+{
+  return count;
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline void TStack<T, Alloc, Growth, Stats, N>::push(const T& element)
+{
+  emplace(element);
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline void TStack<T, Alloc, Growth, Stats, N>::push(T&& element)
+{
+  emplace(std::move(element));
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+template <class... Args>
+inline T& TStack<T, Alloc, Growth, Stats, N>::emplace(Args&&... args)
+{
+  typename Stats::TTimer timer(stats, true);
+  if (!IsFull())
+  {
+    Traits::construct(alloc, memory + count, std::forward<Args>(args)...);
+    stats.OnPush(1, count + 1);
+    return memory[count++];
+  }
+
+  size_t newCap = NextCapacity();
+  T* newMem = Allocate(newCap);
+  try
+  {
+    Traits::construct(alloc, newMem + count, std::forward<Args>(args)...);
+  }
+  catch (...)
+  {
+    Deallocate(newMem, newCap);
+    throw;
   }
-  memory[top] = element;
-  top++;
+  Relocate(newMem);
+
+  Deallocate(memory, capacity);
+  memory = newMem;
+  capacity = newCap;
+  stats.OnPush(1, count + 1);
+  return memory[count++];
 }
 
-template <class T>
-inline T TStack<T>::pop()
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline T TStack<T, Alloc, Growth, Stats, N>::pop()
 {
   if (IsEmpty())
+  {
+    stats.OnEmptyPop();
     throw("Empty stack");
+  }
+  typename Stats::TTimer timer(stats, false);
 
-  return memory[--top];
+  T element = std::move(memory[--count]);
+  Traits::destroy(alloc, memory + count);
+  stats.OnPop(1);
+  return element;
 }
 
-template <class T>
-inline bool TStack<T>::operator==(const TStack<T>& other) const
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline bool TStack<T, Alloc, Growth, Stats, N>::try_push(const T& element)
 {
-  if (top != other.top)
+  if (IsFull() && !CanGrow())
     return false;
+  emplace(element);
+  return true;
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline bool TStack<T, Alloc, Growth, Stats, N>::try_push(T&& element)
+{
+  if (IsFull() && !CanGrow())
+    return false;
+  emplace(std::move(element));
+  return true;
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline bool TStack<T, Alloc, Growth, Stats, N>::try_pop(T& element) noexcept(is_nothrow_move_assignable_v<T>)
+{
+  if (IsEmpty())
+  {
+    stats.OnEmptyPop();
+    return false;
+  }
+  typename Stats::TTimer timer(stats, false);
+  element = std::move(memory[count - 1]);
+  count--;
+  Traits::destroy(alloc, memory + count);
+  stats.OnPop(1);
+  return true;
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline optional<T> TStack<T, Alloc, Growth, Stats, N>::try_pop() noexcept(is_nothrow_move_constructible_v<T>)
+{
+  if (IsEmpty())
+  {
+    stats.OnEmptyPop();
+    return nullopt;
+  }
+  typename Stats::TTimer timer(stats, false);
+  optional<T> element(std::move(memory[count - 1]));
+  count--;
+  Traits::destroy(alloc, memory + count);
+  stats.OnPop(1);
+  return element;
+}
 
-  for (size_t i = 0; i < top; ++i)
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline T& TStack<T, Alloc, Growth, Stats, N>::top() noexcept
+{
+  return memory[count - 1];
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline const T& TStack<T, Alloc, Growth, Stats, N>::top() const noexcept
+{
+  return memory[count - 1];
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+template <class InputIt>
+inline size_t TStack<T, Alloc, Growth, Stats, N>::push_range(InputIt first, InputIt last)
+{
+  if constexpr (forward_iterator<InputIt>)
+  {
+    size_t n = distance(first, last);
+    if (!GrowTo(count + n))
+      GrowTo(min(count + n, growth.Limit()));
+    n = min(n, capacity - count);
+
+    if constexpr (contiguous_iterator<InputIt> && is_trivially_copyable_v<T> && is_same_v<iter_value_t<InputIt>, T>)
+    {
+      if (n != 0)
+        memcpy(memory + count, to_address(first), n * sizeof(T));
+      count += n;
+    }
+    else
+    {
+      for (size_t i = 0; i < n; ++i, ++first)
+      {
+        Traits::construct(alloc, memory + count, *first);
+        count++;
+      }
+    }
+    stats.OnPush(n, count);
+    return n;
+  }
+  else
+  {
+    size_t n = 0;
+    for (; first != last; ++first, ++n)
+    {
+      if (IsFull() && !GrowTo(count + 1))
+        break;
+      Traits::construct(alloc, memory + count, *first);
+      count++;
+    }
+    stats.OnPush(n, count);
+    return n;
+  }
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline size_t TStack<T, Alloc, Growth, Stats, N>::push_range(span<const T> elements)
+{
+  return push_range(elements.begin(), elements.end());
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+template <class OutputIt>
+inline size_t TStack<T, Alloc, Growth, Stats, N>::pop_range(OutputIt out, size_t n)
+{
+  if (n != 0 && count == 0)
+    stats.OnEmptyPop();
+  n = min(n, count);
+  T* first = memory + count - n;
+
+  if constexpr (is_same_v<OutputIt, T*> && is_trivially_copyable_v<T>)
+  {
+    if (n != 0)
+      memcpy(out, first, n * sizeof(T));
+  }
+  else
+  {
+    for (size_t i = 0; i < n; ++i, ++out)
+      *out = std::move(first[i]);
+  }
+
+  if constexpr (!is_trivially_destructible_v<T>)
+  {
+    for (size_t i = 0; i < n; ++i)
+      Traits::destroy(alloc, first + i);
+  }
+  count -= n;
+  stats.OnPop(n);
+  return n;
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline size_t TStack<T, Alloc, Growth, Stats, N>::pop_range(span<T> out)
+{
+  return pop_range(out.data(), out.size());
+}
+
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline bool TStack<T, Alloc, Growth, Stats, N>::operator==(const TStack<T, Alloc, Growth, Stats, N>& other) const
+{
+  if (count != other.count)
+    return false;
+
+  for (size_t i = 0; i < count; ++i)
   {
     if (memory[i] != other.memory[i])
       return false;
@@ -194,112 +576,153 @@ inline bool TStack<T>::operator==(const TStack<T>& other) const
   return true;
 }
 
-template <class T>
-inline bool TStack<T>::operator!=(const TStack<T>& other) const
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline bool TStack<T, Alloc, Growth, Stats, N>::operator!=(const TStack<T, Alloc, Growth, Stats, N>& other) const
 {
   return !(*this == other);
 }
 
-template <class T>
-inline T TStack<T>::operator[](size_t index) const
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline T TStack<T, Alloc, Growth, Stats, N>::operator[](size_t index) const
 {
-  if (index >= top)
+  if (index >= count)
     throw("Index out of range");
   return memory[index];
 }
 
-template <class T>
-inline bool TStack<T>::IsEmpty() const
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline bool TStack<T, Alloc, Growth, Stats, N>::IsEmpty() const
 {
-  return top == 0;
+  return count == 0;
 }
 
-template <class T>
-inline bool TStack<T>::IsFull() const
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline bool TStack<T, Alloc, Growth, Stats, N>::IsFull() const
 {
-  return top == capacity;
+  return count == capacity;
 }
 
 
-template <class T>
-inline TStack<T>::TIterator::TIterator(TStack<T> &stack, size_t start, size_t cnt) : p(stack), cur(start), prev(cnt) {}
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline TStack<T, Alloc, Growth, Stats, N>::TIterator::TIterator(TStack<T, Alloc, Growth, Stats, N>& stack, size_t start, size_t cnt) : p(stack), cur(start), prev(cnt) {}
 
-template <class T>
-inline T& TStack<T>::TIterator::operator*()
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline T& TStack<T, Alloc, Growth, Stats, N>::TIterator::operator*()
 {
   return p.memory[cur];
 }
 
-template <class T>
-inline typename TStack<T>::TIterator& TStack<T>::TIterator::operator++()
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline typename TStack<T, Alloc, Growth, Stats, N>::TIterator& TStack<T, Alloc, Growth, Stats, N>::TIterator::operator++()
 {
   cur++;
   prev++;
   return *this;
 }
 
-template <class T>
-inline typename TStack<T>::TIterator TStack<T>::TIterator::operator++(int)
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline typename TStack<T, Alloc, Growth, Stats, N>::TIterator TStack<T, Alloc, Growth, Stats, N>::TIterator::operator++(int)
 {
   TIterator temp = *this;
   ++(*this);
   return temp;
 }
 
-template <class T>
-inline bool TStack<T>::TIterator::operator==(const TIterator& other) const
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline bool TStack<T, Alloc, Growth, Stats, N>::TIterator::operator==(const TIterator& other) const
 {
   return &p == &other.p && prev == other.prev;
 }
 
-template <class T>
-inline bool TStack<T>::TIterator::operator!=(const TIterator& other) const
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline bool TStack<T, Alloc, Growth, Stats, N>::TIterator::operator!=(const TIterator& other) const
 {
   return !(*this == other);
 }
 
-template <class T>
-inline typename TStack<T>::TIterator TStack<T>::begin()
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline typename TStack<T, Alloc, Growth, Stats, N>::TIterator TStack<T, Alloc, Growth, Stats, N>::begin()
 {
   return TIterator(*this, 0, 0);
 }
 
-template <class T>
-inline typename TStack<T>::TIterator TStack<T>::end()
+template <class T, class Alloc, class Growth, class Stats, size_t N>
+inline typename TStack<T, Alloc, Growth, Stats, N>::TIterator TStack<T, Alloc, Growth, Stats, N>::end()
 {
-  return TIterator(*this, top, top);
+  return TIterator(*this, count, count);
 }
 
-template <class I>
-inline istream& operator>>(istream& is, TStack<I>& stack)
+template <class I, class A, class G, class S, size_t M>
+inline istream& operator>>(istream& is, TStack<I, A, G, S, M>& stack)
 {
-  stack.top = 0;
+  stack.Clear();
   size_t n;
   is >> n;
 
-  if (n > stack.capacity)
-    stack.SetCapacity(n);
+  if (!stack.GrowTo(n))
+    throw("Wrong element count");
 
   for (size_t i = 0; i < n; ++i)
   {
     I element;
     is >> element;
-    stack.push(element);
+    stack.push(std::move(element));
   }
 
   return is;
 }
 
-template <class O>
-inline ostream& operator<<(ostream& os, const TStack<O>& stack)
+template <class O, class A, class G, class S, size_t M>
+inline ostream& operator<<(ostream& os, const TStack<O, A, G, S, M>& stack)
 {
   os << "[";
-  for (size_t i = 0; i < stack.top; ++i) 
+  for (size_t i = 0; i < stack.count; ++i) 
   {
     os << stack.memory[i];
-    if (i < stack.top - 1)
+    if (i < stack.count - 1)
       os << ", ";
   }
   os << "]";
   return os;
 }
+
+template <class I, class A, class G, class S, size_t M>
+inline istream& ReadBinary(istream& is, TStack<I, A, G, S, M>& stack)
+{
+  bool bounded;
+  size_t n = ReadBinaryHeader<I>(is, TBinaryHeader::stackKind, bounded);
+  stack.Clear();
+
+  for (size_t done = 0; done < n;)
+  {
+    size_t batch = ReadBinaryBatch<I>(n - done, bounded);
+    if (!stack.GrowTo(done + batch))
+      throw("Wrong element count");
+
+    if constexpr (TSerializer<I>::bulk)
+    {
+      ReadBinaryBytes(is, stack.memory + done, batch * sizeof(I));
+      stack.count = done + batch;
+      stack.stats.OnPush(batch, stack.count);
+    }
+    else
+    {
+      for (size_t i = 0; i < batch; ++i)
+        stack.push(TSerializer<I>::Read(is));
+    }
+    done += batch;
+  }
+
+  return is;
+}
+
+template <class O, class A, class G, class S, size_t M>
+inline ostream& WriteBinary(ostream& os, const TStack<O, A, G, S, M>& stack)
+{
+  WriteBinaryHeader<O>(os, TBinaryHeader::stackKind, stack.count);
+  WriteBinaryRun(os, stack.memory, stack.count);
+  return os;
+}
+
+template <class T, size_t N = 16>
+using TSmallStack = TStack<T, allocator<T>, TGeometricGrowth, TNoStats, N>;
@@ -0,0 +1 @@
+#include "TStaticQueue.h"
@@ -0,0 +1,220 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <iostream>
+#include <utility>
+
+using namespace std;
+
+template <class T, size_t N>
+class TStaticQueue
+{
+  static_assert(N > 0 && has_single_bit(N), "TStaticQueue needs a power-of-two capacity");
+protected:
+  static constexpr size_t mask = N - 1;
+
+  array<T, N> memory;
+  size_t head;
+  size_t tail;
+public:
+  constexpr TStaticQueue();
+
+  static constexpr size_t GetCapacity();
+  constexpr size_t GetFront() const;
+  constexpr size_t GetRear() const;
+
+  constexpr size_t Size() const;
+  constexpr bool enqueue(const T& element);
+  constexpr bool enqueue(T&& element);
+  constexpr bool dequeue(T& element);
+  constexpr void Clear();
+
+  constexpr T& front();
+  constexpr const T& front() const;
+  constexpr T& operator[](size_t index);
+  constexpr const T& operator[](size_t index) const;
+
+  constexpr bool IsEmpty() const;
+  constexpr bool IsFull() const;
+
+  class TIterator
+  {
+  protected:
+    TStaticQueue* p;
+    size_t cur;
+  public:
+    constexpr TIterator(TStaticQueue* queue, size_t start);
+    constexpr T& operator*() const;
+    constexpr TIterator& operator++();
+    constexpr TIterator operator++(int);
+
+    constexpr bool operator==(const TIterator& other) const;
+    constexpr bool operator!=(const TIterator& other) const;
+  };
+
+  constexpr TIterator begin();
+  constexpr TIterator end();
+
+  template <class O, size_t M>
+  friend ostream& operator<<(ostream& os, const TStaticQueue<O, M>& queue);
+};
+
+template <class T, size_t N>
+inline constexpr TStaticQueue<T, N>::TStaticQueue() : memory(), head(0), tail(0) {}
+
+template <class T, size_t N>
+inline constexpr size_t TStaticQueue<T, N>::GetCapacity()
+{
+  return N;
+}
+
+template <class T, size_t N>
+inline constexpr size_t TStaticQueue<T, N>::GetFront() const
+{
+  return head & mask;
+}
+
+template <class T, size_t N>
+inline constexpr size_t TStaticQueue<T, N>::GetRear() const
+{
+  return tail & mask;
+}
+
+template <class T, size_t N>
+inline constexpr size_t TStaticQueue<T, N>::Size() const
+{
+  return tail - head;
+}
+
+template <class T, size_t N>
+inline constexpr bool TStaticQueue<T, N>::enqueue(const T& element)
+{
+  if (tail - head == N)
+    return false;
+  memory[tail++ & mask] = element;
+  return true;
+}
+
+template <class T, size_t N>
+inline constexpr bool TStaticQueue<T, N>::enqueue(T&& element)
+{
+  if (tail - head == N)
+    return false;
+  memory[tail++ & mask] = std::move(element);
+  return true;
+}
+
+template <class T, size_t N>
+inline constexpr bool TStaticQueue<T, N>::dequeue(T& element)
+{
+  if (tail == head)
+    return false;
+  element = std::move(memory[head++ & mask]);
+  return true;
+}
+
+template <class T, size_t N>
+inline constexpr void TStaticQueue<T, N>::Clear()
+{
+  head = 0;
+  tail = 0;
+}
+
+template <class T, size_t N>
+inline constexpr T& TStaticQueue<T, N>::front()
+{
+  return memory[head & mask];
+}
+
+template <class T, size_t N>
+inline constexpr const T& TStaticQueue<T, N>::front() const
+{
+  return memory[head & mask];
+}
+
+template <class T, size_t N>
+inline constexpr T& TStaticQueue<T, N>::operator[](size_t index)
+{
+  return memory[(head + index) & mask];
+}
+
+template <class T, size_t N>
+inline constexpr const T& TStaticQueue<T, N>::operator[](size_t index) const
+{
+  return memory[(head + index) & mask];
+}
+
+template <class T, size_t N>
+inline constexpr bool TStaticQueue<T, N>::IsEmpty() const
+{
+  return tail == head;
+}
+
+template <class T, size_t N>
+inline constexpr bool TStaticQueue<T, N>::IsFull() const
+{
+  return tail - head == N;
+}
+
+template <class T, size_t N>
+inline constexpr TStaticQueue<T, N>::TIterator::TIterator(TStaticQueue* queue, size_t start) : p(queue), cur(start) {}
+
+template <class T, size_t N>
+inline constexpr T& TStaticQueue<T, N>::TIterator::operator*() const
+{
+  return p->memory[cur & mask];
+}
+
+template <class T, size_t N>
+inline constexpr typename TStaticQueue<T, N>::TIterator& TStaticQueue<T, N>::TIterator::operator++()
+{
+  cur++;
+  return *this;
+}
+
+template <class T, size_t N>
+inline constexpr typename TStaticQueue<T, N>::TIterator TStaticQueue<T, N>::TIterator::operator++(int)
+{
+  TIterator temp = *this;
+  ++(*this);
+  return temp;
+}
+
+template <class T, size_t N>
+inline constexpr bool TStaticQueue<T, N>::TIterator::operator==(const TIterator& other) const
+{
+  return p == other.p && cur == other.cur;
+}
+
+template <class T, size_t N>
+inline constexpr bool TStaticQueue<T, N>::TIterator::operator!=(const TIterator& other) const
+{
+  return !(*this == other);
+}
+
+template <class T, size_t N>
+inline constexpr typename TStaticQueue<T, N>::TIterator TStaticQueue<T, N>::begin()
+{
+  return TIterator(this, head);
+}
+
+template <class T, size_t N>
+inline constexpr typename TStaticQueue<T, N>::TIterator TStaticQueue<T, N>::end()
+{
+  return TIterator(this, tail);
+}
+
+template <class O, size_t M>
+inline ostream& operator<<(ostream& os, const TStaticQueue<O, M>& queue)
+{
+  os << "[";
+  for (size_t i = queue.head; i != queue.tail; ++i)
+  {
+    os << queue.memory[i & queue.mask];
+    if (i + 1 != queue.tail)
+      os << ", ";
+  }
+  os << "]";
+  return os;
+}
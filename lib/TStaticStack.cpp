@@ -0,0 +1 @@
+#include "TStaticStack.h"
@@ -0,0 +1,164 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <utility>
+
+using namespace std;
+
+template <class T, size_t N>
+class TStaticStack
+{
+  static_assert(N > 0, "TStaticStack needs a non-zero capacity");
+protected:
+  array<T, N> memory;
+  size_t count;
+public:
+  constexpr TStaticStack();
+
+  static constexpr size_t GetCapacity();
+
+  constexpr size_t Size() const;
+  constexpr bool push(const T& element);
+  constexpr bool push(T&& element);
+  constexpr bool pop(T& element);
+  constexpr void Clear();
+
+  constexpr T& top();
+  constexpr const T& top() const;
+  constexpr T& operator[](size_t index);
+  constexpr const T& operator[](size_t index) const;
+
+  constexpr bool IsEmpty() const;
+  constexpr bool IsFull() const;
+
+  constexpr T* begin();
+  constexpr T* end();
+  constexpr const T* begin() const;
+  constexpr const T* end() const;
+
+  template <class O, size_t M>
+  friend ostream& operator<<(ostream& os, const TStaticStack<O, M>& stack);
+};
+
+template <class T, size_t N>
+inline constexpr TStaticStack<T, N>::TStaticStack() : memory(), count(0) {}
+
+template <class T, size_t N>
+inline constexpr size_t TStaticStack<T, N>::GetCapacity()
+{
+  return N;
+}
+
+template <class T, size_t N>
+inline constexpr size_t TStaticStack<T, N>::Size() const
+{
+  return count;
+}
+
+template <class T, size_t N>
+inline constexpr bool TStaticStack<T, N>::push(const T& element)
+{
+  if (count == N)
+    return false;
+  memory[count++] = element;
+  return true;
+}
+
+template <class T, size_t N>
+inline constexpr bool TStaticStack<T, N>::push(T&& element)
+{
+  if (count == N)
+    return false;
+  memory[count++] = std::move(element);
+  return true;
+}
+
+template <class T, size_t N>
+inline constexpr bool TStaticStack<T, N>::pop(T& element)
+{
+  if (count == 0)
+    return false;
+  element = std::move(memory[--count]);
+  return true;
+}
+
+template <class T, size_t N>
+inline constexpr void TStaticStack<T, N>::Clear()
+{
+  count = 0;
+}
+
+template <class T, size_t N>
+inline constexpr T& TStaticStack<T, N>::top()
+{
+  return memory[count - 1];
+}
+
+template <class T, size_t N>
+inline constexpr const T& TStaticStack<T, N>::top() const
+{
+  return memory[count - 1];
+}
+
+template <class T, size_t N>
+inline constexpr T& TStaticStack<T, N>::operator[](size_t index)
+{
+  return memory[index];
+}
+
+template <class T, size_t N>
+inline constexpr const T& TStaticStack<T, N>::operator[](size_t index) const
+{
+  return memory[index];
+}
+
+template <class T, size_t N>
+inline constexpr bool TStaticStack<T, N>::IsEmpty() const
+{
+  return count == 0;
+}
+
+template <class T, size_t N>
+inline constexpr bool TStaticStack<T, N>::IsFull() const
+{
+  return count == N;
+}
+
+template <class T, size_t N>
+inline constexpr T* TStaticStack<T, N>::begin()
+{
+  return memory.data();
+}
+
+template <class T, size_t N>
+inline constexpr T* TStaticStack<T, N>::end()
+{
+  return memory.data() + count;
+}
+
+template <class T, size_t N>
+inline constexpr const T* TStaticStack<T, N>::begin() const
+{
+  return memory.data();
+}
+
+template <class T, size_t N>
+inline constexpr const T* TStaticStack<T, N>::end() const
+{
+  return memory.data() + count;
+}
+
+template <class O, size_t M>
+inline ostream& operator<<(ostream& os, const TStaticStack<O, M>& stack)
+{
+  os << "[";
+  for (size_t i = 0; i < stack.count; ++i)
+  {
+    os << stack.memory[i];
+    if (i < stack.count - 1)
+      os << ", ";
+  }
+  os << "]";
+  return os;
+}
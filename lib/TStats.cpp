@@ -0,0 +1 @@
+#include "TStats.h"
@@ -0,0 +1,234 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+class THistogram
+{
+protected:
+  static constexpr size_t subBits = 5;
+  static constexpr size_t subCount = size_t(1) << subBits;
+  static constexpr size_t maxShift = 40;
+  static constexpr size_t bucketCount = (maxShift + 2) * subCount;
+
+  uint64_t buckets[bucketCount];
+  uint64_t count;
+  uint64_t maxValue;
+
+  static size_t Bucket(uint64_t value);
+  static uint64_t Highest(size_t bucket);
+public:
+  THistogram();
+
+  void Record(uint64_t value);
+  void Reset();
+
+  uint64_t GetCount() const;
+  uint64_t GetMax() const;
+  uint64_t Percentile(double q) const;
+};
+
+struct TNoStats
+{
+  struct TTimer
+  {
+    TTimer(TNoStats&, bool) {}
+  };
+
+  void OnPush(size_t, size_t) {}
+  void OnPop(size_t) {}
+  void OnEmptyPop() {}
+  void OnResize(size_t) {}
+};
+
+class TOpStats
+{
+protected:
+  uint64_t pushes;
+  uint64_t pops;
+  uint64_t emptyPops;
+  uint64_t resizes;
+  uint64_t bytesCopied;
+  size_t peak;
+  THistogram pushLatency;
+  THistogram popLatency;
+public:
+  class TTimer
+  {
+  protected:
+    THistogram& histogram;
+    chrono::steady_clock::time_point start;
+  public:
+    TTimer(TOpStats& stats, bool push);
+    ~TTimer();
+  };
+
+  TOpStats();
+
+  void OnPush(size_t n, size_t size);
+  void OnPop(size_t n);
+  void OnEmptyPop();
+  void OnResize(size_t bytes);
+  void Reset();
+
+  uint64_t GetPushes() const;
+  uint64_t GetPops() const;
+  uint64_t GetEmptyPops() const;
+  uint64_t GetResizes() const;
+  uint64_t GetBytesCopied() const;
+  size_t GetPeak() const;
+  const THistogram& GetPushLatency() const;
+  const THistogram& GetPopLatency() const;
+};
+
+inline size_t THistogram::Bucket(uint64_t value)
+{
+  size_t width = bit_width(value);
+  size_t shift = width > subBits + 1 ? width - subBits - 1 : 0;
+  if (shift > maxShift)
+    return bucketCount - 1;
+  return shift * subCount + (size_t)(value >> shift);
+}
+
+inline uint64_t THistogram::Highest(size_t bucket)
+{
+  if (bucket < 2 * subCount)
+    return bucket;
+  size_t shift = bucket / subCount - 1;
+  return ((uint64_t)(bucket - shift * subCount) << shift) + ((uint64_t(1) << shift) - 1);
+}
+
+inline THistogram::THistogram()
+{
+  Reset();
+}
+
+inline void THistogram::Record(uint64_t value)
+{
+  buckets[Bucket(value)]++;
+  count++;
+  maxValue = max(maxValue, value);
+}
+
+inline void THistogram::Reset()
+{
+  fill(buckets, buckets + bucketCount, 0);
+  count = 0;
+  maxValue = 0;
+}
+
+inline uint64_t THistogram::GetCount() const
+{
+  return count;
+}
+
+inline uint64_t THistogram::GetMax() const
+{
+  return maxValue;
+}
+
+inline uint64_t THistogram::Percentile(double q) const
+{
+  if (count == 0)
+    return 0;
+
+  uint64_t rank = (uint64_t)(q * count);
+  if (rank >= count)
+    rank = count - 1;
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < bucketCount; ++i)
+  {
+    seen += buckets[i];
+    if (seen > rank)
+      return min(Highest(i), maxValue);
+  }
+  return maxValue;
+}
+
+inline TOpStats::TTimer::TTimer(TOpStats& stats, bool push) : histogram(push ? stats.pushLatency : stats.popLatency), start(chrono::steady_clock::now()) {}
+
+inline TOpStats::TTimer::~TTimer()
+{
+  histogram.Record(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+}
+
+inline TOpStats::TOpStats() : pushes(0), pops(0), emptyPops(0), resizes(0), bytesCopied(0), peak(0) {}
+
+inline void TOpStats::OnPush(size_t n, size_t size)
+{
+  pushes += n;
+  peak = max(peak, size);
+}
+
+inline void TOpStats::OnPop(size_t n)
+{
+  pops += n;
+}
+
+inline void TOpStats::OnEmptyPop()
+{
+  emptyPops++;
+}
+
+inline void TOpStats::OnResize(size_t bytes)
+{
+  resizes++;
+  bytesCopied += bytes;
+}
+
+inline void TOpStats::Reset()
+{
+  pushes = 0;
+  pops = 0;
+  emptyPops = 0;
+  resizes = 0;
+  bytesCopied = 0;
+  peak = 0;
+  pushLatency.Reset();
+  popLatency.Reset();
+}
+
+inline uint64_t TOpStats::GetPushes() const
+{
+  return pushes;
+}
+
+inline uint64_t TOpStats::GetPops() const
+{
+  return pops;
+}
+
+inline uint64_t TOpStats::GetEmptyPops() const
+{
+  return emptyPops;
+}
+
+inline uint64_t TOpStats::GetResizes() const
+{
+  return resizes;
+}
+
+inline uint64_t TOpStats::GetBytesCopied() const
+{
+  return bytesCopied;
+}
+
+inline size_t TOpStats::GetPeak() const
+{
+  return peak;
+}
+
+inline const THistogram& TOpStats::GetPushLatency() const
+{
+  return pushLatency;
+}
+
+inline const THistogram& TOpStats::GetPopLatency() const
+{
+  return popLatency;
+}
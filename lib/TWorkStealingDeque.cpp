@@ -0,0 +1 @@
+#include "TWorkStealingDeque.h"
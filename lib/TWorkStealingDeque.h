@@ -0,0 +1,174 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+template <class T>
+class TWorkStealingDeque
+{
+  static_assert(is_trivially_copyable_v<T>, "TWorkStealingDeque requires a trivially copyable element type");
+protected:
+  static constexpr size_t cacheLine = 64;
+
+  struct TArray
+  {
+    size_t capacity;
+    size_t mask;
+    atomic<T>* cells;
+
+    TArray(size_t capacity_);
+    ~TArray();
+
+    T Get(int64_t index) const;
+    void Put(int64_t index, const T& element);
+  };
+
+  alignas(cacheLine) atomic<int64_t> top;
+  alignas(cacheLine) atomic<int64_t> bottom;
+  atomic<TArray*> array;
+  vector<TArray*> retired;
+
+  TArray* Grow(TArray* old, int64_t b, int64_t t);
+public:
+  TWorkStealingDeque(size_t capacity_ = 64);
+  TWorkStealingDeque(const TWorkStealingDeque& other) = delete;
+  TWorkStealingDeque& operator=(const TWorkStealingDeque& other) = delete;
+  ~TWorkStealingDeque();
+
+  size_t GetCapacity() const;
+
+  size_t Size() const;
+  void push(const T& element);
+  bool pop(T& element);
+  bool steal(T& element);
+
+  bool IsEmpty() const;
+};
+
+template <class T>
+inline TWorkStealingDeque<T>::TArray::TArray(size_t capacity_) : capacity(capacity_), mask(capacity_ - 1), cells(new atomic<T>[capacity_]) {}
+
+template <class T>
+inline TWorkStealingDeque<T>::TArray::~TArray()
+{
+  delete[] cells;
+}
+
+template <class T>
+inline T TWorkStealingDeque<T>::TArray::Get(int64_t index) const
+{
+  return cells[(size_t)index & mask].load(memory_order_relaxed);
+}
+
+template <class T>
+inline void TWorkStealingDeque<T>::TArray::Put(int64_t index, const T& element)
+{
+  cells[(size_t)index & mask].store(element, memory_order_relaxed);
+}
+
+template <class T>
+inline typename TWorkStealingDeque<T>::TArray* TWorkStealingDeque<T>::Grow(TArray* old, int64_t b, int64_t t)
+{
+  TArray* grown = new TArray(old->capacity * 2);
+  for (int64_t i = t; i < b; ++i)
+    grown->Put(i, old->Get(i));
+  retired.push_back(old);
+  array.store(grown, memory_order_release);
+  return grown;
+}
+
+template <class T>
+inline TWorkStealingDeque<T>::TWorkStealingDeque(size_t capacity_) : top(0), bottom(0), array(nullptr)
+{
+  if (capacity_ == 0)
+    throw("Wrong capacity");
+  array.store(new TArray(bit_ceil(capacity_)), memory_order_relaxed);
+}
+
+template <class T>
+inline TWorkStealingDeque<T>::~TWorkStealingDeque()
+{
+  delete array.load(memory_order_relaxed);
+  for (TArray* old : retired)
+    delete old;
+}
+
+template <class T>
+inline size_t TWorkStealingDeque<T>::GetCapacity() const
+{
+  return array.load(memory_order_acquire)->capacity;
+}
+
+template <class T>
+inline size_t TWorkStealingDeque<T>::Size() const
+{
+  int64_t b = bottom.load(memory_order_acquire);
+  int64_t t = top.load(memory_order_acquire);
+  return b > t ? (size_t)(b - t) : 0;
+}
+
+template <class T>
+inline void TWorkStealingDeque<T>::push(const T& element)
+{
+  int64_t b = bottom.load(memory_order_relaxed);
+  int64_t t = top.load(memory_order_acquire);
+  TArray* a = array.load(memory_order_relaxed);
+  if (b - t > (int64_t)a->capacity - 1)
+    a = Grow(a, b, t);
+  a->Put(b, element);
+  atomic_thread_fence(memory_order_release);
+  bottom.store(b + 1, memory_order_relaxed);
+}
+
+template <class T>
+inline bool TWorkStealingDeque<T>::pop(T& element)
+{
+  int64_t b = bottom.load(memory_order_relaxed) - 1;
+  TArray* a = array.load(memory_order_relaxed);
+  bottom.store(b, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  int64_t t = top.load(memory_order_relaxed);
+
+  if (t > b)
+  {
+    bottom.store(b + 1, memory_order_relaxed);
+    return false;
+  }
+
+  element = a->Get(b);
+  if (t == b)
+  {
+    bool won = top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+    bottom.store(b + 1, memory_order_relaxed);
+    return won;
+  }
+  return true;
+}
+
+template <class T>
+inline bool TWorkStealingDeque<T>::steal(T& element)
+{
+  int64_t t = top.load(memory_order_acquire);
+  atomic_thread_fence(memory_order_seq_cst);
+  int64_t b = bottom.load(memory_order_acquire);
+  if (t >= b)
+    return false;
+
+  TArray* a = array.load(memory_order_acquire);
+  T candidate = a->Get(t);
+  if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+    return false;
+  element = candidate;
+  return true;
+}
+
+template <class T>
+inline bool TWorkStealingDeque<T>::IsEmpty() const
+{
+  return Size() == 0;
+}
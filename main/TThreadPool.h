@@ -0,0 +1,153 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "TEventCount.h"
+#include "TMPMCQueue.h"
+#include "TWorkStealingDeque.h"
+
+using namespace std;
+
+class TThreadPool
+{
+protected:
+  using TTask = function<void()>;
+
+  struct TWorker
+  {
+    TWorkStealingDeque<TTask*> deque;
+    size_t executed = 0;
+    size_t stolen = 0;
+  };
+
+  struct TCurrent
+  {
+    TThreadPool* pool = nullptr;
+    size_t index = 0;
+  };
+
+  vector<unique_ptr<TWorker>> workers;
+  vector<thread> threads;
+  TMPMCQueue<TTask*> injected;
+  atomic<size_t> pending;
+  atomic<bool> stop;
+  TEventCount idle;
+  TEventCount done;
+
+  static TCurrent& Current();
+  bool Next(size_t index, TTask*& task);
+  void Run(size_t index);
+public:
+  TThreadPool(size_t count);
+  TThreadPool(const TThreadPool& other) = delete;
+  TThreadPool& operator=(const TThreadPool& other) = delete;
+  ~TThreadPool();
+
+  size_t GetWorkers() const;
+  size_t GetExecuted(size_t index) const;
+  size_t GetStolen(size_t index) const;
+
+  void Submit(TTask task);
+  void Wait();
+};
+
+inline TThreadPool::TCurrent& TThreadPool::Current()
+{
+  thread_local TCurrent current;
+  return current;
+}
+
+inline bool TThreadPool::Next(size_t index, TTask*& task)
+{
+  TWorker& self = *workers[index];
+  if (self.deque.pop(task) || injected.try_dequeue(task))
+    return true;
+
+  for (size_t i = 1; i < workers.size(); ++i)
+  {
+    TWorker& victim = *workers[(index + i) % workers.size()];
+    if (victim.deque.steal(task))
+    {
+      self.stolen++;
+      return true;
+    }
+  }
+  return false;
+}
+
+inline void TThreadPool::Run(size_t index)
+{
+  Current() = { this, index };
+  TTask* task;
+  while (true)
+  {
+    bool found = false;
+    idle.Await([&]() { return (found = Next(index, task)) || stop.load(memory_order_acquire); });
+    if (!found)
+      return;
+
+    (*task)();
+    delete task;
+    workers[index]->executed++;
+    if (pending.fetch_sub(1, memory_order_acq_rel) == 1)
+      done.NotifyAll();
+  }
+}
+
+inline TThreadPool::TThreadPool(size_t count) : injected(1024), pending(0), stop(false)
+{
+  if (count == 0)
+    throw("Wrong worker count");
+  for (size_t i = 0; i < count; ++i)
+    workers.push_back(make_unique<TWorker>());
+  for (size_t i = 0; i < count; ++i)
+    threads.emplace_back(&TThreadPool::Run, this, i);
+}
+
+inline TThreadPool::~TThreadPool()
+{
+  Wait();
+  stop.store(true, memory_order_release);
+  idle.NotifyAll();
+  for (auto& t : threads)
+    t.join();
+}
+
+inline size_t TThreadPool::GetWorkers() const
+{
+  return workers.size();
+}
+
+inline size_t TThreadPool::GetExecuted(size_t index) const
+{
+  return workers[index]->executed;
+}
+
+inline size_t TThreadPool::GetStolen(size_t index) const
+{
+  return workers[index]->stolen;
+}
+
+inline void TThreadPool::Submit(TTask task)
+{
+  pending.fetch_add(1, memory_order_relaxed);
+  TTask* boxed = new TTask(std::move(task));
+  TCurrent& current = Current();
+  if (current.pool == this)
+    workers[current.index]->deque.push(boxed);
+  else
+  {
+    while (!injected.enqueue_for(boxed, chrono::milliseconds(1)))
+      idle.NotifyAll();
+  }
+  idle.NotifyOne();
+}
+
+inline void TThreadPool::Wait()
+{
+  done.Await([&]() { return pending.load(memory_order_acquire) == 0; });
+}
@@ -1,7 +1,23 @@
+#include <atomic>
 #include <iostream>
 #include "TStack.h"
 #include "TQueue.h"
+#include "TThreadPool.h"
 
+static void Sum(TThreadPool& pool, atomic<long long>& total, long long from, long long to)
+{
+  if (to - from <= 1000)
+  {
+    long long sum = 0;
+    for (long long i = from; i < to; ++i)
+      sum += i;
+    total += sum;
+    return;
+  }
+  long long middle = from + (to - from) / 2;
+  pool.Submit([&pool, &total, from, middle]() { Sum(pool, total, from, middle); });
+  pool.Submit([&pool, &total, middle, to]() { Sum(pool, total, middle, to); });
+}
 
 int main()
 {
@@ -23,4 +39,13 @@ int main()
 
   queue.enqueue(4);
   cout << queue << endl; // [2, 3, 4]
+
+  TThreadPool pool(max(2u, thread::hardware_concurrency()));
+  atomic<long long> total(0);
+  const long long n = 10000000;
+  pool.Submit([&]() { Sum(pool, total, 0, n); });
+  pool.Wait();
+  cout << "sum [0, " << n << ") = " << total << endl; // 49999995000000
+  for (size_t i = 0; i < pool.GetWorkers(); ++i)
+    cout << "worker " << i << ": " << pool.GetExecuted(i) << " tasks, " << pool.GetStolen(i) << " stolen" << endl;
 }
\ No newline at end of file
@@ -1,7 +1,76 @@
 #include <gtest.h>
 #include "TStack.h"
 #include "TQueue.h"
+#include "TSPSCQueue.h"
+#include "TMPMCQueue.h"
+#include "TConcurrentStack.h"
+#include "TEliminationStack.h"
+#include "TStats.h"
+#include "TMappedQueue.h"
+#include "TSharedQueue.h"
+#include "TWorkStealingDeque.h"
+#include "TPriorityQueue.h"
+#include "TSegmentedQueue.h"
+#include "TSegmentedStack.h"
+#include "TStaticStack.h"
+#include "TStaticQueue.h"
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <sstream>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#if __has_include(<sys/wait.h>)
+#include <sys/wait.h>
+#endif
+#include <list>
+#include <thread>
+#include <vector>
+
+
+struct TLifetime
+{
+  static int alive;
+  static int defaultConstructed;
+  int value;
+
+  TLifetime() : value(0) { alive++; defaultConstructed++; }
+  TLifetime(int value_) : value(value_) { alive++; }
+  TLifetime(const TLifetime& other) : value(other.value) { alive++; }
+  TLifetime(TLifetime&& other) : value(other.value) { alive++; }
+  TLifetime& operator=(const TLifetime& other) { value = other.value; return *this; }
+  ~TLifetime() { alive--; }
+};
+
+int TLifetime::alive = 0;
+int TLifetime::defaultConstructed = 0;
+
+template <class T>
+struct TCountingAllocator
+{
+  using value_type = T;
+
+  size_t* allocated;
+
+  TCountingAllocator(size_t* allocated_) : allocated(allocated_) {}
+  template <class U>
+  TCountingAllocator(const TCountingAllocator<U>& other) : allocated(other.allocated) {}
 
+  T* allocate(size_t n)
+  {
+    *allocated += n;
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* p, size_t n)
+  {
+    *allocated -= n;
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  bool operator==(const TCountingAllocator& other) const { return allocated == other.allocated; }
+};
 
 TEST(TStackTest, DefaultConstructor)
 {
@@ -126,6 +195,25 @@ TEST(TStackTest, SetCapacity)
   EXPECT_EQ(stack.pop(), 1);
 }
 
+TEST(TStackTest, SetMemoryKeepsElements)
+{
+  TStack<int> stack(4);
+  stack.push(1);
+  stack.push(2);
+  stack.push(3);
+
+  allocator<int> alloc;
+  int* memory = alloc.allocate(stack.GetCapacity());
+  for (size_t i = 0; i < stack.Size(); i++)
+    memory[i] = stack[i] * 10;
+  stack.SetMemory(memory);
+  EXPECT_EQ(stack.Size(), 3);
+  EXPECT_EQ(stack.GetMemory(), memory);
+  EXPECT_EQ(stack.pop(), 30);
+  EXPECT_EQ(stack.pop(), 20);
+  EXPECT_EQ(stack.pop(), 10);
+}
+
 TEST(TStackTest, Iterator)
 {
   TStack<int> stack(3);
@@ -146,6 +234,62 @@ TEST(TStackTest, Iterator)
   EXPECT_EQ(*it, 2);
 }
 
+TEST(TStackTest, PushMovesElement)
+{
+  TStack<std::string> stack(2);
+  std::string s(100, 'a');
+  stack.push(std::move(s));
+  EXPECT_TRUE(s.empty());
+  EXPECT_EQ(stack.pop(), std::string(100, 'a'));
+}
+
+TEST(TStackTest, Emplace)
+{
+  TStack<std::string> stack;
+  std::string& element = stack.emplace(3, 'x');
+  EXPECT_EQ(element, "xxx");
+  element += "y";
+  EXPECT_EQ(stack.pop(), "xxxy");
+}
+
+TEST(TStackTest, MoveOnlyElements)
+{
+  TStack<std::unique_ptr<int>> stack(1);
+  stack.push(std::make_unique<int>(1));
+  stack.emplace(new int(2));
+  EXPECT_EQ(*stack.pop(), 2);
+  EXPECT_EQ(*stack.pop(), 1);
+}
+
+TEST(TStackTest, ConstructsOnlyLiveElements)
+{
+  TLifetime::alive = 0;
+  TLifetime::defaultConstructed = 0;
+  {
+    TStack<TLifetime> stack(100);
+    EXPECT_EQ(TLifetime::alive, 0);
+    for (int i = 0; i < 150; ++i)
+      stack.emplace(i);
+    EXPECT_EQ(TLifetime::alive, 150);
+    EXPECT_EQ(stack.pop().value, 149);
+    EXPECT_EQ(TLifetime::alive, 149);
+
+    TStack<TLifetime> copy(stack);
+    EXPECT_EQ(TLifetime::alive, 298);
+  }
+  EXPECT_EQ(TLifetime::alive, 0);
+  EXPECT_EQ(TLifetime::defaultConstructed, 0);
+}
+
+TEST(TStackTest, PushOwnElementWhileGrowing)
+{
+  TStack<std::string> stack(1);
+  stack.push(std::string(50, 'a'));
+  stack.push(*stack.begin());
+  EXPECT_EQ(stack.pop(), std::string(50, 'a'));
+  EXPECT_EQ(stack.pop(), std::string(50, 'a'));
+}
+
 TEST(TQueueTest, DefaultConstructor)
 {
   TQueue<int> queue;
@@ -309,6 +453,1336 @@ TEST(TQueueTest, Iterator)
 }
 
 
+TEST(TQueueTest, EnqueueMovesElement)
+{
+  TQueue<std::string> queue(2);
+  std::string s(100, 'a');
+  queue.enqueue(std::move(s));
+  EXPECT_TRUE(s.empty());
+  EXPECT_EQ(queue.dequeue(), std::string(100, 'a'));
+}
+
+TEST(TQueueTest, Emplace)
+{
+  TQueue<std::string> queue;
+  queue.emplace(2, 'a');
+  std::string& element = queue.emplace("b");
+  element += "c";
+  EXPECT_EQ(queue.dequeue(), "aa");
+  EXPECT_EQ(queue.dequeue(), "bc");
+}
+
+TEST(TQueueTest, MoveOnlyElements)
+{
+  TQueue<std::unique_ptr<int>> queue(1);
+  queue.enqueue(std::make_unique<int>(1));
+  queue.emplace(new int(2));
+  EXPECT_EQ(*queue.dequeue(), 1);
+  EXPECT_EQ(*queue.dequeue(), 2);
+}
+
+
+TEST(TQueueTest, ConstructsOnlyLiveElements)
+{
+  TLifetime::alive = 0;
+  TLifetime::defaultConstructed = 0;
+  {
+    TQueue<TLifetime> queue(4);
+    EXPECT_EQ(TLifetime::alive, 0);
+    for (int i = 0; i < 3; ++i)
+      queue.emplace(i);
+    EXPECT_EQ(queue.dequeue().value, 0);
+    for (int i = 3; i < 10; ++i)
+      queue.emplace(i);
+    EXPECT_EQ(TLifetime::alive, 9);
+    EXPECT_EQ(queue.dequeue().value, 1);
+    EXPECT_EQ(TLifetime::alive, 8);
+
+    TQueue<TLifetime> copy(queue);
+    EXPECT_EQ(TLifetime::alive, 16);
+    EXPECT_EQ(copy.dequeue().value, 2);
+  }
+  EXPECT_EQ(TLifetime::alive, 0);
+  EXPECT_EQ(TLifetime::defaultConstructed, 0);
+}
+
+TEST(TQueueTest, SetFrontAndRearKeepContents)
+{
+  TQueue<std::string> queue(4);
+  queue.enqueue("a");
+  queue.enqueue("b");
+
+  queue.SetFront(3);
+  EXPECT_EQ(queue.GetFront(), 3);
+  EXPECT_EQ(queue.GetRear(), 1);
+  queue.SetRear(3);
+  EXPECT_EQ(queue.GetFront(), 1);
+  EXPECT_EQ(queue.dequeue(), "a");
+  EXPECT_EQ(queue.dequeue(), "b");
+
+  queue.SetCount(2);
+  EXPECT_EQ(queue.Size(), 2);
+  EXPECT_EQ(queue.dequeue(), "");
+}
+
+
+TEST(TQueueTest, WrappedGrowthAndCopy)
+{
+  TQueue<int> ints(4);
+  TQueue<std::string> strings(4);
+  for (int i = 0; i < 4; ++i)
+  {
+    ints.enqueue(i);
+    strings.enqueue(std::to_string(i));
+  }
+  ints.dequeue();
+  ints.dequeue();
+  strings.dequeue();
+  strings.dequeue();
+  for (int i = 4; i < 7; ++i)
+  {
+    ints.enqueue(i);
+    strings.enqueue(std::to_string(i));
+  }
+
+  TQueue<int> intsCopy(ints);
+  TQueue<std::string> stringsCopy(strings);
+  ints.SetFront(6);
+  strings.SetFront(6);
+  for (int i = 2; i < 7; ++i)
+  {
+    EXPECT_EQ(ints.dequeue(), i);
+    EXPECT_EQ(intsCopy.dequeue(), i);
+    EXPECT_EQ(strings.dequeue(), std::to_string(i));
+    EXPECT_EQ(stringsCopy.dequeue(), std::to_string(i));
+  }
+  EXPECT_TRUE(ints.IsEmpty());
+  EXPECT_TRUE(stringsCopy.IsEmpty());
+}
+
+
+TEST(TQueueTest, Pow2IndexRoundsCapacity)
+{
+  TQueue<int, TPow2Index> queue(5);
+  EXPECT_EQ(queue.GetCapacity(), 8);
+  queue.SetCapacity(9);
+  EXPECT_EQ(queue.GetCapacity(), 16);
+
+  TQueue<int, TPow2Index> grown;
+  grown.enqueue(1);
+  EXPECT_EQ(grown.GetCapacity(), 16);
+}
+
+TEST(TQueueTest, Pow2IndexWrapsAndGrows)
+{
+  TQueue<int, TPow2Index> queue(4);
+  int next = 0;
+  int expected = 0;
+  for (int round = 0; round < 10; ++round)
+  {
+    for (int i = 0; i < 3; ++i)
+      queue.enqueue(next++);
+    for (int i = 0; i < 2; ++i)
+      EXPECT_EQ(queue.dequeue(), expected++);
+    EXPECT_LT(queue.GetFront(), queue.GetCapacity());
+  }
+  EXPECT_EQ(queue.Size(), 10);
+  EXPECT_EQ(queue.GetCapacity(), 16);
+
+  int i = expected;
+  for (auto it = queue.begin(); it != queue.end(); ++it)
+    EXPECT_EQ(*it, i++);
+  EXPECT_EQ(queue[0], expected);
+
+  std::stringstream ss;
+  ss << queue;
+  EXPECT_EQ(ss.str(), "[20, 21, 22, 23, 24, 25, 26, 27, 28, 29]");
+
+  TQueue<int, TPow2Index> copy(queue);
+  EXPECT_TRUE(copy == queue);
+  while (!queue.IsEmpty())
+    EXPECT_EQ(queue.dequeue(), expected++);
+}
+
+
+TEST(AllocatorTest, StackUsesAllocator)
+{
+  size_t allocated = 0;
+  {
+    TStack<std::string, TCountingAllocator<std::string>> stack(2, TCountingAllocator<std::string>(&allocated));
+    EXPECT_EQ(allocated, 2);
+    for (int i = 0; i < 5; ++i)
+      stack.push(std::to_string(i));
+    EXPECT_EQ(allocated, 8);
+
+    TStack<std::string, TCountingAllocator<std::string>> copy(stack);
+    EXPECT_EQ(allocated, 16);
+    TStack<std::string, TCountingAllocator<std::string>> moved(std::move(copy));
+    EXPECT_EQ(allocated, 16);
+    EXPECT_EQ(moved.pop(), "4");
+    EXPECT_EQ(moved.GetAllocator().allocated, &allocated);
+  }
+  EXPECT_EQ(allocated, 0);
+}
+
+TEST(AllocatorTest, QueueUsesAllocator)
+{
+  size_t allocated = 0;
+  {
+    TQueue<int, TPow2Index, TCountingAllocator<int>> queue{TCountingAllocator<int>(&allocated)};
+    EXPECT_EQ(allocated, 0);
+    for (int i = 0; i < 20; ++i)
+      queue.enqueue(i);
+    EXPECT_EQ(allocated, 32);
+    queue.SetCapacity(20);
+    EXPECT_EQ(allocated, 32);
+    EXPECT_EQ(queue.dequeue(), 0);
+  }
+  EXPECT_EQ(allocated, 0);
+}
+
+TEST(AllocatorTest, PolymorphicArena)
+{
+  char buffer[4096];
+  std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+  TStack<int, std::pmr::polymorphic_allocator<int>> stack(&arena);
+  TQueue<std::pmr::string, TModuloIndex, std::pmr::polymorphic_allocator<std::pmr::string>> queue(4, &arena);
+  for (int i = 0; i < 50; ++i)
+    stack.push(i);
+  queue.emplace("short");
+  queue.emplace(std::string(100, 'x'));
+
+  EXPECT_EQ(stack.pop(), 49);
+  EXPECT_EQ(queue.dequeue(), "short");
+  EXPECT_EQ(queue.dequeue().size(), 100);
+  EXPECT_EQ(stack.GetAllocator().resource(), &arena);
+}
+
+
+TEST(GrowthTest, GeometricFactorAndInitial)
+{
+  TStack<int> stack;
+  stack.SetGrowth(TGeometricGrowth(4, 1.5));
+  for (int i = 0; i < 5; ++i)
+    stack.push(i);
+  EXPECT_EQ(stack.GetCapacity(), 6);
+  EXPECT_THROW(TGeometricGrowth(4, 0.5), const char*);
+}
+
+TEST(GrowthTest, FixedStep)
+{
+  TQueue<int, TModuloIndex, std::allocator<int>, TFixedGrowth> queue;
+  queue.SetGrowth(TFixedGrowth(3));
+  for (int i = 0; i < 7; ++i)
+    queue.enqueue(i);
+  EXPECT_EQ(queue.GetCapacity(), 9);
+  EXPECT_EQ(queue.dequeue(), 0);
+}
+
+TEST(GrowthTest, CappedRejectsPastMaximum)
+{
+  TStack<int, std::allocator<int>, TCappedGrowth> stack;
+  stack.SetGrowth(TCappedGrowth(15));
+  for (int i = 0; i < 15; ++i)
+    stack.push(i);
+  EXPECT_EQ(stack.GetCapacity(), 15);
+  EXPECT_THROW(stack.push(15), const char*);
+  EXPECT_THROW(stack.reserve(16), const char*);
+  EXPECT_EQ(stack.pop(), 14);
+}
+
+TEST(GrowthTest, NoGrowthRejects)
+{
+  TQueue<int, TModuloIndex, std::allocator<int>, TNoGrowth> queue(2);
+  queue.enqueue(1);
+  queue.enqueue(2);
+  EXPECT_THROW(queue.enqueue(3), const char*);
+  EXPECT_EQ(queue.Size(), 2);
+
+  queue.reserve(3);
+  queue.enqueue(3);
+  EXPECT_EQ(queue.GetCapacity(), 3);
+}
+
+TEST(GrowthTest, ReserveAndShrinkToFit)
+{
+  TStack<int> stack;
+  stack.reserve(100);
+  EXPECT_EQ(stack.GetCapacity(), 100);
+  stack.push(1);
+  stack.shrink_to_fit();
+  EXPECT_EQ(stack.GetCapacity(), 1);
+  EXPECT_EQ(stack.pop(), 1);
+
+  TQueue<int, TPow2Index> queue;
+  queue.reserve(20);
+  EXPECT_EQ(queue.GetCapacity(), 32);
+  for (int i = 0; i < 5; ++i)
+    queue.enqueue(i);
+  queue.shrink_to_fit();
+  EXPECT_EQ(queue.GetCapacity(), 8);
+  EXPECT_EQ(queue.dequeue(), 0);
+}
+
+
+TEST(RangeTest, StackPushAndPopRange)
+{
+  TStack<int> stack(2);
+  int input[] = {1, 2, 3, 4, 5};
+  EXPECT_EQ(stack.push_range(std::span<const int>(input)), 5);
+  EXPECT_EQ(stack.Size(), 5);
+  EXPECT_EQ(stack.GetCapacity(), 5);
+
+  int output[3] = {};
+  EXPECT_EQ(stack.pop_range(std::span<int>(output)), 3);
+  EXPECT_EQ(output[0], 3);
+  EXPECT_EQ(output[1], 4);
+  EXPECT_EQ(output[2], 5);
+  EXPECT_EQ(stack.pop(), 2);
+
+  std::list<std::string> words = {"a", "b"};
+  TStack<std::string> strings;
+  EXPECT_EQ(strings.push_range(words.begin(), words.end()), 2);
+  std::vector<std::string> out;
+  EXPECT_EQ(strings.pop_range(std::back_inserter(out), 10), 2);
+  EXPECT_EQ(out, std::vector<std::string>({"a", "b"}));
+  EXPECT_TRUE(strings.IsEmpty());
+}
+
+TEST(RangeTest, StackPushRangeStopsWhenGrowthRejected)
+{
+  TStack<int, std::allocator<int>, TNoGrowth> stack(3);
+  stack.push(0);
+  int input[] = {1, 2, 3, 4};
+  EXPECT_EQ(stack.push_range(std::begin(input), std::end(input)), 2);
+  EXPECT_EQ(stack.pop(), 2);
+
+  std::istringstream is("7 8 9");
+  EXPECT_EQ(stack.push_range(std::istream_iterator<int>(is), std::istream_iterator<int>()), 1);
+  EXPECT_EQ(stack.pop(), 7);
+}
+
+TEST(RangeTest, QueueRangesWrapAround)
+{
+  TQueue<int> queue(6);
+  for (int i = 0; i < 4; ++i)
+    queue.enqueue(i);
+  queue.dequeue();
+  queue.dequeue();
+  queue.dequeue();
+
+  int input[] = {4, 5, 6, 7, 8};
+  EXPECT_EQ(queue.enqueue_range(std::span<const int>(input)), 5);
+  EXPECT_EQ(queue.GetCapacity(), 6);
+  EXPECT_EQ(queue.GetRear(), 3);
+
+  int output[6] = {};
+  EXPECT_EQ(queue.dequeue_range(std::span<int>(output)), 6);
+  for (int i = 0; i < 6; ++i)
+    EXPECT_EQ(output[i], i + 3);
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(RangeTest, QueueRangesGrowOnceAndMoveStrings)
+{
+  TQueue<std::string, TPow2Index> queue(2);
+  queue.enqueue("x");
+  std::vector<std::string> input = {"a", "b", "c", "d"};
+  EXPECT_EQ(queue.enqueue_range(input.begin(), input.end()), 4);
+  EXPECT_EQ(queue.GetCapacity(), 8);
+
+  std::vector<std::string> out(5);
+  EXPECT_EQ(queue.dequeue_range(out.begin(), 10), 5);
+  EXPECT_EQ(out, std::vector<std::string>({"x", "a", "b", "c", "d"}));
+}
+
+
+TEST(StatsTest, HistogramPercentiles)
+{
+  THistogram histogram;
+  for (uint64_t i = 1; i <= 1000; ++i)
+    histogram.Record(i);
+  EXPECT_EQ(histogram.GetCount(), 1000);
+  EXPECT_EQ(histogram.GetMax(), 1000);
+  EXPECT_NEAR((double)histogram.Percentile(0.5), 500.0, 500.0 / 32);
+  EXPECT_NEAR((double)histogram.Percentile(0.99), 990.0, 990.0 / 32);
+  EXPECT_EQ(histogram.Percentile(1.0), 1000);
+}
+
+TEST(StatsTest, StackCountsOperations)
+{
+  TStack<int, std::allocator<int>, TGeometricGrowth, TOpStats> stack(2);
+  for (int i = 0; i < 5; ++i)
+    stack.push(i);
+  stack.pop();
+  int values[3] = { 7, 8, 9 };
+  stack.push_range(span<const int>(values));
+  int out[10];
+  EXPECT_EQ(stack.pop_range(span<int>(out)), 7);
+  EXPECT_THROW(stack.pop(), const char*);
+  const TOpStats& stats = stack.GetStats();
+  EXPECT_EQ(stats.GetPushes(), 8);
+  EXPECT_EQ(stats.GetPops(), 8);
+  EXPECT_EQ(stats.GetEmptyPops(), 1);
+  EXPECT_EQ(stats.GetResizes(), 2);
+  EXPECT_EQ(stats.GetBytesCopied(), (2 + 4) * sizeof(int));
+  EXPECT_EQ(stats.GetPeak(), 7);
+  EXPECT_EQ(stats.GetPushLatency().GetCount(), 5);
+  EXPECT_EQ(stats.GetPopLatency().GetCount(), 1);
+  stack.ResetStats();
+  EXPECT_EQ(stack.GetStats().GetPushes(), 0);
+}
+
+TEST(StatsTest, QueueCountsOperations)
+{
+  TQueue<int, TModuloIndex, std::allocator<int>, TGeometricGrowth, TOpStats> queue(4);
+  for (int i = 0; i < 6; ++i)
+    queue.enqueue(i);
+  EXPECT_EQ(queue.dequeue(), 0);
+  TQueue<int, TModuloIndex, std::allocator<int>, TGeometricGrowth, TOpStats> copy(queue);
+  EXPECT_EQ(copy.GetStats().GetPushes(), 0);
+  const TOpStats& stats = queue.GetStats();
+  EXPECT_EQ(stats.GetPushes(), 6);
+  EXPECT_EQ(stats.GetPops(), 1);
+  EXPECT_EQ(stats.GetResizes(), 1);
+  EXPECT_EQ(stats.GetBytesCopied(), 4 * sizeof(int));
+  EXPECT_EQ(stats.GetPeak(), 6);
+}
+
+TEST(StatsTest, NoStatsAddsNoStorage)
+{
+  EXPECT_EQ(sizeof(TStack<int>), sizeof(TGeometricGrowth) + sizeof(size_t) * 2 + sizeof(int*));
+  EXPECT_GT(sizeof(TStack<int, std::allocator<int>, TGeometricGrowth, TOpStats>), sizeof(TStack<int>));
+}
+
+TEST(BinaryTest, StackRoundTrip)
+{
+  TStack<int> stack(4);
+  for (int i = 0; i < 100; i++)
+    stack.push(i);
+  stringstream stream;
+  WriteBinary(stream, stack);
+  ASSERT_EQ(sizeof(TBinaryHeader) + 100 * sizeof(int), stream.str().size());
+  TStack<int> result;
+  ReadBinary(stream, result);
+  ASSERT_EQ(stack, result);
+  ASSERT_EQ(99, result.pop());
+}
+
+TEST(BinaryTest, WrappedQueueRoundTrip)
+{
+  TQueue<int> queue(8);
+  for (int i = 0; i < 6; i++)
+    queue.enqueue(i);
+  for (int i = 0; i < 4; i++)
+    queue.dequeue();
+  for (int i = 6; i < 12; i++)
+    queue.enqueue(i);
+  stringstream stream;
+  WriteBinary(stream, queue);
+  TQueue<int, TPow2Index> result(2);
+  result.enqueue(-1);
+  ReadBinary(stream, result);
+  ASSERT_EQ(8, result.Size());
+  for (int i = 4; i < 12; i++)
+    ASSERT_EQ(i, result.dequeue());
+}
+
+TEST(BinaryTest, StringsUseSerializer)
+{
+  TQueue<string> queue;
+  queue.enqueue("alpha");
+  queue.enqueue("");
+  queue.enqueue(string(100, 'x'));
+  stringstream stream;
+  WriteBinary(stream, queue);
+  TQueue<string> result;
+  ReadBinary(stream, result);
+  ASSERT_EQ("alpha", result.dequeue());
+  ASSERT_EQ("", result.dequeue());
+  ASSERT_EQ(string(100, 'x'), result.dequeue());
+}
+
+TEST(BinaryTest, RejectsMismatchedInput)
+{
+  TStack<int> stack;
+  stack.push(1);
+  stringstream stream;
+  WriteBinary(stream, stack);
+  string data = stream.str();
+
+  TQueue<int> queue;
+  stringstream kind(data);
+  ASSERT_THROW(ReadBinary(kind, queue), const char*);
+
+  TStack<double> doubles;
+  stringstream size(data);
+  ASSERT_THROW(ReadBinary(size, doubles), const char*);
+
+  TStack<int> result;
+  stringstream truncated(data.substr(0, data.size() - 1));
+  ASSERT_THROW(ReadBinary(truncated, result), const char*);
+}
+
+TEST(BinaryTest, ReportsForeignByteOrder)
+{
+  TStack<int> stack;
+  stack.push(1);
+  stringstream stream;
+  WriteBinary(stream, stack);
+  string data = stream.str();
+
+  auto swap = [&](size_t offset, size_t size) { reverse(data.begin() + offset, data.begin() + offset + size); };
+  swap(offsetof(TBinaryHeader, tag), sizeof(uint32_t));
+  swap(offsetof(TBinaryHeader, format), sizeof(uint16_t));
+  data[offsetof(TBinaryHeader, order)] = TBinaryHeader::NativeOrder() == 1 ? 2 : 1;
+  swap(offsetof(TBinaryHeader, elementSize), sizeof(uint32_t));
+  swap(offsetof(TBinaryHeader, count), sizeof(uint64_t));
+  swap(sizeof(TBinaryHeader), sizeof(int));
+
+  TStack<int> result;
+  stringstream swapped(data);
+  try
+  {
+    ReadBinary(swapped, result);
+    FAIL();
+  }
+  catch (const char* error)
+  {
+    ASSERT_STREQ("Wrong byte order", error);
+  }
+}
+
+TEST(BinaryTest, RejectsCountBeyondInput)
+{
+  TQueue<int> queue;
+  queue.enqueue(1);
+  stringstream stream;
+  WriteBinary(stream, queue);
+  string data = stream.str();
+  uint64_t count = 1ull << 40;
+  memcpy(data.data() + offsetof(TBinaryHeader, count), &count, sizeof(count));
+
+  TQueue<int> result;
+  stringstream huge(data);
+  ASSERT_THROW(ReadBinary(huge, result), const char*);
+  ASSERT_EQ(0, result.GetCapacity());
+
+  TQueue<string> strings;
+  strings.enqueue("abc");
+  stringstream text;
+  WriteBinary(text, strings);
+  data = text.str();
+  memcpy(data.data() + sizeof(TBinaryHeader), &count, sizeof(count));
+  TQueue<string> stringResult;
+  stringstream longString(data);
+  ASSERT_THROW(ReadBinary(longString, stringResult), const char*);
+}
+
+struct TForwardBuffer : streambuf
+{
+  string data;
+
+  TForwardBuffer(string data_) : data(std::move(data_))
+  {
+    setg(data.data(), data.data(), data.data() + data.size());
+  }
+};
+
+TEST(BinaryTest, ReadsNonSeekableStreamInBatches)
+{
+  TQueue<int> queue;
+  for (int i = 0; i < 300000; ++i)
+    queue.enqueue(i);
+  TStack<string> strings;
+  strings.push(string(3 << 20, 'q'));
+  strings.push("tail");
+  stringstream stream;
+  WriteBinary(stream, queue);
+  WriteBinary(stream, strings);
+
+  TForwardBuffer buffer(stream.str());
+  istream in(&buffer);
+  ASSERT_EQ(in.tellg(), streampos(-1));
+  TQueue<int> result;
+  ReadBinary(in, result);
+  ASSERT_EQ(result.Size(), 300000);
+  for (int i = 0; i < 300000; ++i)
+    ASSERT_EQ(result[i], i);
+  TStack<string> stringResult;
+  ReadBinary(in, stringResult);
+  EXPECT_EQ(stringResult.pop(), "tail");
+  EXPECT_EQ(stringResult.pop().size(), 3u << 20);
+}
+
+TEST(BinaryTest, ReadingRespectsGrowthPolicy)
+{
+  TStack<int> stack;
+  for (int i = 0; i < 5; ++i)
+    stack.push(i);
+  stringstream binary;
+  WriteBinary(binary, stack);
+  TStack<int, std::allocator<int>, TNoGrowth> fixed(2);
+  EXPECT_THROW(ReadBinary(binary, fixed), const char*);
+  EXPECT_EQ(fixed.GetCapacity(), 2);
+
+  stringstream text("5 1 2 3 4 5");
+  TQueue<int, TModuloIndex, std::allocator<int>, TCappedGrowth> capped;
+  capped.SetGrowth(TCappedGrowth(4, 2));
+  EXPECT_THROW(text >> capped, const char*);
+  EXPECT_LE(capped.GetCapacity(), 4);
+}
+
+#if __has_include(<sys/mman.h>)
+TEST(TMappedQueueTest, ContentsSurviveReopen)
+{
+  string path = (filesystem::temp_directory_path() / "mapped_queue_reopen.bin").string();
+  remove(path.c_str());
+  {
+    TMappedQueue<int> queue(path, 4);
+    for (int i = 0; i < 4; i++)
+      queue.enqueue(i);
+    ASSERT_EQ(0, queue.dequeue());
+    queue.enqueue(4);
+    queue.Sync();
+  }
+  {
+    TMappedQueue<int> queue(path);
+    ASSERT_EQ(4, queue.GetCapacity());
+    ASSERT_EQ(4, queue.Size());
+    for (int i = 1; i <= 4; i++)
+      ASSERT_EQ(i, queue.dequeue());
+    ASSERT_TRUE(queue.IsEmpty());
+  }
+  remove(path.c_str());
+}
+
+TEST(TMappedQueueTest, GrowsWrappedRingByRemapping)
+{
+  string path = (filesystem::temp_directory_path() / "mapped_queue_grow.bin").string();
+  remove(path.c_str());
+  {
+    TMappedQueue<double> queue(path, 4);
+    for (int i = 0; i < 3; i++)
+      queue.enqueue(i);
+    queue.dequeue();
+    queue.dequeue();
+    for (int i = 3; i < 20; i++)
+      queue.enqueue(i);
+    ASSERT_LT(4, queue.GetCapacity());
+    ASSERT_EQ(18, queue.Size());
+    ASSERT_EQ(2.0, queue[0]);
+    ASSERT_EQ(19.0, queue[17]);
+  }
+  {
+    TMappedQueue<double> queue(path);
+    for (int i = 2; i < 20; i++)
+      ASSERT_EQ((double)i, queue.dequeue());
+    ASSERT_THROW(queue.dequeue(), const char*);
+  }
+  remove(path.c_str());
+}
+
+TEST(TMappedQueueTest, ElementsNeedNoDefaultConstructor)
+{
+  struct TPoint
+  {
+    int x, y;
+    TPoint(int x_, int y_) : x(x_), y(y_) {}
+  };
+  string path = (filesystem::temp_directory_path() / "mapped_queue_point.bin").string();
+  remove(path.c_str());
+  {
+    TMappedQueue<TPoint> queue(path, 2);
+    for (int i = 0; i < 5; ++i)
+      queue.enqueue(TPoint(i, -i));
+    EXPECT_EQ(queue[4].y, -4);
+    EXPECT_EQ(queue.dequeue().x, 0);
+    queue.Clear();
+    EXPECT_TRUE(queue.IsEmpty());
+  }
+  remove(path.c_str());
+}
+
+TEST(TMappedQueueTest, RejectsForeignFile)
+{
+  string path = (filesystem::temp_directory_path() / "mapped_queue_foreign.bin").string();
+  remove(path.c_str());
+  {
+    TMappedQueue<int> queue(path, 2);
+    queue.enqueue(1);
+  }
+  ASSERT_THROW(TMappedQueue<double> queue(path), const char*);
+  remove(path.c_str());
+}
+
+TEST(TMappedQueueTest, RejectsCorruptHeader)
+{
+  string path = (filesystem::temp_directory_path() / "mapped_queue_corrupt.bin").string();
+  remove(path.c_str());
+  {
+    TMappedQueue<int> queue(path, 4);
+    queue.enqueue(1);
+    queue.enqueue(2);
+  }
+  auto patch = [&](size_t offset, uint64_t value)
+  {
+    FILE* file = fopen(path.c_str(), "r+b");
+    ASSERT_NE(nullptr, file);
+    fseek(file, (long)offset, SEEK_SET);
+    fwrite(&value, sizeof(value), 1, file);
+    fclose(file);
+  };
+
+  patch(24, 3);
+  ASSERT_THROW(TMappedQueue<int> queue(path), const char*);
+  patch(24, 0);
+  patch(32, 5);
+  ASSERT_THROW(TMappedQueue<int> queue(path), const char*);
+  patch(32, 2);
+  patch(16, 1000);
+  ASSERT_THROW(TMappedQueue<int> queue(path), const char*);
+  patch(16, 4);
+  patch(8, 2);
+  ASSERT_THROW(TMappedQueue<int> queue(path), const char*);
+  patch(8, 0);
+  patch(24, 3);
+  patch(32, 5);
+  patch(40, 1000);
+
+  filesystem::resize_file(path, filesystem::file_size(path) + 64);
+  {
+    TMappedQueue<int> queue(path);
+    ASSERT_EQ(4, queue.GetCapacity());
+    ASSERT_EQ(2, queue.Size());
+    ASSERT_EQ(1, queue.GetRear());
+  }
+  remove(path.c_str());
+}
+
+TEST(TSharedQueueTest, OpenerSeesOwnerRecords)
+{
+  TSharedQueue<int>::Remove("/stackqueue_test_open");
+  TSharedQueue<int> owner("/stackqueue_test_open", 5);
+  TSharedQueue<int> peer("/stackqueue_test_open");
+  ASSERT_TRUE(owner.IsOwner());
+  ASSERT_FALSE(peer.IsOwner());
+  ASSERT_EQ(8, peer.GetCapacity());
+  for (int i = 0; i < 8; i++)
+    ASSERT_TRUE(owner.enqueue(i));
+  ASSERT_FALSE(owner.enqueue(8));
+  ASSERT_TRUE(peer.IsFull());
+  int value;
+  for (int i = 0; i < 8; i++)
+  {
+    ASSERT_TRUE(peer.dequeue(value));
+    ASSERT_EQ(i, value);
+  }
+  ASSERT_FALSE(peer.dequeue(value));
+  ASSERT_THROW(TSharedQueue<double> wrong("/stackqueue_test_open"), const char*);
+}
+
+TEST(TSharedQueueTest, OpenerRejectsCorruptCapacity)
+{
+  TSharedQueue<int>::Remove("/stackqueue_test_corrupt");
+  TSharedQueue<int> owner("/stackqueue_test_corrupt", 8);
+
+  int fd = shm_open("/stackqueue_test_corrupt", O_RDWR, 0600);
+  ASSERT_GE(fd, 0);
+  void* p = mmap(nullptr, 64, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  ASSERT_NE(MAP_FAILED, p);
+  uint64_t* capacity = reinterpret_cast<uint64_t*>(static_cast<char*>(p) + 8);
+  ASSERT_EQ(8u, *capacity);
+
+  for (uint64_t wrong : { uint64_t(0), uint64_t(6), uint64_t(16), uint64_t(1) << 62 })
+  {
+    *capacity = wrong;
+    ASSERT_THROW(TSharedQueue<int> peer("/stackqueue_test_corrupt"), const char*);
+  }
+  *capacity = 8;
+  TSharedQueue<int> peer("/stackqueue_test_corrupt");
+  ASSERT_EQ(8, peer.GetCapacity());
+  munmap(p, 64);
+}
+
+TEST(TSharedQueueTest, RecordsCrossProcessBoundary)
+{
+  struct TRecord
+  {
+    int id;
+    double value;
+  };
+  const int n = 20000;
+  TSharedQueue<TRecord, false>::Remove("/stackqueue_test_fork");
+  TSharedQueue<TRecord, false> consumer("/stackqueue_test_fork", 64);
+  pid_t pid = fork();
+  ASSERT_NE(-1, pid);
+  if (pid == 0)
+  {
+    TSharedQueue<TRecord, false> producer("/stackqueue_test_fork");
+    for (int i = 0; i < n; i++)
+    {
+      while (!producer.enqueue({ i, i * 0.5 }))
+        this_thread::yield();
+    }
+    _exit(0);
+  }
+  TRecord record;
+  for (int i = 0; i < n; i++)
+  {
+    while (!consumer.dequeue(record))
+      this_thread::yield();
+    ASSERT_EQ(i, record.id);
+    ASSERT_EQ(i * 0.5, record.value);
+  }
+  int status;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(0, WEXITSTATUS(status));
+}
+#endif
+
+TEST(TPriorityQueueTest, PopsInPriorityOrder)
+{
+  TPriorityQueue<int> queue;
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_THROW(queue.pop(), const char*);
+
+  mt19937 random(7);
+  vector<int> values;
+  for (int i = 0; i < 1000; ++i)
+  {
+    values.push_back((int)(random() % 500));
+    queue.push(values.back());
+  }
+  sort(values.rbegin(), values.rend());
+  EXPECT_EQ(queue.Size(), 1000);
+  EXPECT_EQ(queue.top(), values[0]);
+  for (int value : values)
+    EXPECT_EQ(queue.pop(), value);
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(TPriorityQueueTest, HeapifyFromRangeAndMinOrder)
+{
+  vector<int> values = { 5, 3, 9, 1, 7, 2, 8 };
+  TPriorityQueue<int, greater<int>, 2> queue(values.begin(), values.end());
+  int more[3] = { 0, 6, 4 };
+  queue.push_range(more, more + 3);
+  EXPECT_EQ(queue.Size(), 10);
+
+  int sum = 0;
+  for (int value : queue)
+    sum += value;
+  EXPECT_EQ(sum, 45);
+
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(queue.pop(), i);
+}
+
+TEST(TPriorityQueueTest, MovesStringsAndStreams)
+{
+  TPriorityQueue<string> queue;
+  queue.push("b");
+  queue.emplace(3, 'c');
+  string a = "a";
+  queue.push(std::move(a));
+
+  stringstream out;
+  out << queue;
+  EXPECT_EQ(out.str(), "[ccc, b, a]");
+
+  stringstream in("4 d x a m");
+  in >> queue;
+  EXPECT_EQ(queue.Size(), 4);
+  EXPECT_EQ(queue.pop(), "x");
+  EXPECT_EQ(queue.pop(), "m");
+}
+
+TEST(TIndexedPriorityQueueTest, DecreaseKeyAndRemove)
+{
+  TIndexedPriorityQueue<int, greater<int>> queue(4);
+  queue.push(0, 50);
+  queue.push(1, 40);
+  queue.push(2, 30);
+  queue.push(7, 20);
+  EXPECT_EQ(queue.GetCapacity(), 8);
+  EXPECT_EQ(queue.top(), 7);
+  EXPECT_THROW(queue.push(1, 10), const char*);
+
+  queue.DecreaseKey(0, 10);
+  EXPECT_EQ(queue.top(), 0);
+  EXPECT_THROW(queue.DecreaseKey(0, 60), const char*);
+  queue.Update(0, 60);
+  queue.Remove(2);
+  EXPECT_FALSE(queue.Contains(2));
+  EXPECT_EQ(queue.GetKey(1), 40);
+
+  EXPECT_EQ(queue.pop(), 7);
+  EXPECT_EQ(queue.pop(), 1);
+  EXPECT_EQ(queue.pop(), 0);
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_THROW(queue.pop(), const char*);
+}
+
+TEST(TIndexedPriorityQueueTest, DecreaseKeyWithDefaultCompare)
+{
+  TIndexedPriorityQueue<int> queue;
+  queue.push(0, 50);
+  queue.push(1, 40);
+  queue.push(2, 30);
+  EXPECT_EQ(queue.top(), 0);
+
+  EXPECT_THROW(queue.DecreaseKey(0, 10), const char*);
+  queue.Update(0, 10);
+  EXPECT_EQ(queue.GetKey(0), 10);
+  EXPECT_EQ(queue.top(), 1);
+
+  queue.DecreaseKey(2, 45);
+  EXPECT_EQ(queue.top(), 2);
+  EXPECT_THROW(queue.DecreaseKey(1, 5), const char*);
+
+  EXPECT_EQ(queue.pop(), 2);
+  EXPECT_EQ(queue.pop(), 1);
+  EXPECT_EQ(queue.pop(), 0);
+}
+
+struct TDeadline
+{
+  int64_t ticks;
+};
+
+struct TEarlierDeadline
+{
+  bool operator()(const TDeadline& a, const TDeadline& b) const
+  {
+    return a.ticks > b.ticks;
+  }
+};
+
+TEST(TIndexedPriorityQueueTest, DecreaseKeyUsesComparator)
+{
+  TIndexedPriorityQueue<TDeadline, TEarlierDeadline> queue;
+  queue.push(0, TDeadline{ 50 });
+  queue.push(1, TDeadline{ 40 });
+  queue.push(2, TDeadline{ 30 });
+  EXPECT_EQ(queue.top(), 2);
+
+  queue.DecreaseKey(0, TDeadline{ 10 });
+  EXPECT_EQ(queue.top(), 0);
+  EXPECT_EQ(queue.GetKey(0).ticks, 10);
+  EXPECT_THROW(queue.DecreaseKey(1, TDeadline{ 45 }), const char*);
+  EXPECT_EQ(queue.GetKey(1).ticks, 40);
+
+  queue.Update(0, TDeadline{ 60 });
+  EXPECT_EQ(queue.pop(), 2);
+  EXPECT_EQ(queue.pop(), 1);
+  EXPECT_EQ(queue.pop(), 0);
+}
+
+TEST(TSegmentedQueueTest, FifoAcrossChunks)
+{
+  TSegmentedQueue<int, 4> queue;
+  EXPECT_THROW(queue.dequeue(), const char*);
+  for (int i = 0; i < 10; ++i)
+    queue.enqueue(i);
+  EXPECT_EQ(queue.Size(), 10);
+  EXPECT_EQ(queue.GetChunks(), 3);
+  EXPECT_EQ(queue[9], 9);
+  EXPECT_THROW(queue[10], const char*);
+
+  int* element = &queue.emplace(10);
+  for (int i = 11; i < 40; ++i)
+    queue.enqueue(i);
+  EXPECT_EQ(*element, 10);
+
+  for (int i = 0; i < 40; ++i)
+    EXPECT_EQ(queue.dequeue(), i);
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(TSegmentedQueueTest, FreedChunksAreRecycled)
+{
+  size_t allocated = 0;
+  TSegmentedQueue<int, 8, TCountingAllocator<int>> queue{TCountingAllocator<int>(&allocated)};
+  for (int round = 0; round < 100; ++round)
+  {
+    for (int i = 0; i < 32; ++i)
+      queue.enqueue(i);
+    for (int i = 0; i < 32; ++i)
+      EXPECT_EQ(queue.dequeue(), i);
+  }
+  EXPECT_LE(queue.GetChunks() + queue.GetPooled(), 5);
+  EXPECT_EQ(allocated, queue.GetChunks() + queue.GetPooled());
+  EXPECT_EQ(queue.GetCapacity(), (queue.GetChunks() + queue.GetPooled()) * 8);
+
+  queue.reserve(100);
+  EXPECT_GE(queue.GetCapacity(), 100);
+  queue.Clear();
+  EXPECT_EQ(queue.GetChunks(), 0);
+  queue.shrink_to_fit();
+  EXPECT_EQ(queue.GetPooled(), 0);
+  EXPECT_EQ(allocated, 0);
+}
+
+TEST(TSegmentedQueueTest, CopyMoveIterateAndStream)
+{
+  TSegmentedQueue<string, 2> queue;
+  queue.enqueue("a");
+  queue.enqueue("b");
+  queue.enqueue("c");
+  queue.dequeue();
+  queue.enqueue("d");
+
+  TSegmentedQueue<string, 2> copy(queue);
+  TSegmentedQueue<string, 2> moved(std::move(queue));
+  EXPECT_TRUE(queue.IsEmpty());
+
+  string joined;
+  for (auto& element : copy)
+    joined += element;
+  EXPECT_EQ(joined, "bcd");
+
+  stringstream out;
+  out << moved;
+  EXPECT_EQ(out.str(), "[b, c, d]");
+
+  stringstream in("3 x y z");
+  in >> moved;
+  EXPECT_EQ(moved.Size(), 3);
+  EXPECT_EQ(moved.dequeue(), "x");
+}
+
+TEST(TSegmentedStackTest, ReferencesStayValid)
+{
+  TSegmentedStack<int, 4> stack;
+  EXPECT_THROW(stack.pop(), const char*);
+  int& first = stack.emplace(0);
+  vector<int*> addresses = { &first };
+  for (int i = 1; i < 1000; ++i)
+  {
+    stack.push(i);
+    addresses.push_back(&stack[i]);
+  }
+  EXPECT_EQ(stack.Size(), 1000);
+  EXPECT_GE(stack.GetCapacity(), 1000);
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_EQ(*addresses[i], i);
+  EXPECT_EQ(&first, &stack[0]);
+  EXPECT_THROW(stack[1000], const char*);
+
+  for (int i = 999; i >= 0; --i)
+    EXPECT_EQ(stack.pop(), i);
+  EXPECT_TRUE(stack.IsEmpty());
+}
+
+TEST(TSegmentedStackTest, KeepsOneSpareBlock)
+{
+  size_t allocated = 0;
+  TSegmentedStack<int, 4, TCountingAllocator<int>> stack{TCountingAllocator<int>(&allocated)};
+  for (int i = 0; i < 12; ++i)
+    stack.push(i);
+  EXPECT_EQ(stack.GetBlocks(), 2);
+  EXPECT_EQ(allocated, 12);
+
+  stack.push(12);
+  EXPECT_EQ(stack.GetBlocks(), 3);
+  stack.pop();
+  EXPECT_EQ(stack.GetBlocks(), 3);
+  for (int i = 0; i < 8; ++i)
+    stack.pop();
+  EXPECT_EQ(stack.GetBlocks(), 2);
+  EXPECT_EQ(allocated, 12);
+
+  stack.shrink_to_fit();
+  EXPECT_EQ(stack.GetBlocks(), 1);
+  EXPECT_EQ(allocated, 4);
+}
+
+TEST(TSegmentedStackTest, CopyMoveIterateAndStream)
+{
+  TSegmentedStack<string, 2> stack;
+  for (string s : { "a", "b", "c", "d", "e" })
+    stack.push(s);
+
+  TSegmentedStack<string, 2> copy(stack);
+  TSegmentedStack<string, 2> moved(std::move(stack));
+  EXPECT_TRUE(stack.IsEmpty());
+
+  string joined;
+  for (auto& element : copy)
+    joined += element;
+  EXPECT_EQ(joined, "abcde");
+
+  stringstream out;
+  out << moved;
+  EXPECT_EQ(out.str(), "[a, b, c, d, e]");
+
+  stringstream in("2 x y");
+  in >> moved;
+  EXPECT_EQ(moved.Size(), 2);
+  EXPECT_EQ(moved.pop(), "y");
+}
+
+TEST(InlineTest, StackStaysInlineUntilOverflow)
+{
+  size_t allocated = 0;
+  TStack<int, TCountingAllocator<int>, TGeometricGrowth, TNoStats, 4> stack{TCountingAllocator<int>(&allocated)};
+  EXPECT_EQ(stack.GetCapacity(), 4);
+  for (int i = 0; i < 4; ++i)
+    stack.push(i);
+  EXPECT_EQ(allocated, 0);
+
+  stack.push(4);
+  EXPECT_GT(allocated, 0);
+  EXPECT_EQ(stack.pop(), 4);
+  stack.shrink_to_fit();
+  EXPECT_EQ(allocated, 0);
+  EXPECT_EQ(stack.GetCapacity(), 4);
+  for (int i = 3; i >= 0; --i)
+    EXPECT_EQ(stack.pop(), i);
+}
+
+TEST(InlineTest, SmallStackCopyAndMove)
+{
+  TSmallStack<string, 4> stack;
+  stack.push("a");
+  stack.push("b");
+  TSmallStack<string, 4> copy(stack);
+  TSmallStack<string, 4> moved(std::move(stack));
+  EXPECT_TRUE(stack.IsEmpty());
+  EXPECT_EQ(stack.GetCapacity(), 4);
+  stack.push("c");
+  EXPECT_EQ(copy.pop(), "b");
+  EXPECT_EQ(moved.pop(), "b");
+  EXPECT_EQ(moved.pop(), "a");
+  EXPECT_EQ(stack.pop(), "c");
+  EXPECT_NE(moved.GetMemory(), stack.GetMemory());
+}
+
+TEST(InlineTest, SmallQueueWrapsInlineAndGrows)
+{
+  size_t allocated = 0;
+  TQueue<int, TModuloIndex, TCountingAllocator<int>, TGeometricGrowth, TNoStats, 4> queue{TCountingAllocator<int>(&allocated)};
+  for (int i = 0; i < 3; ++i)
+    queue.enqueue(i);
+  queue.dequeue();
+  queue.dequeue();
+  for (int i = 3; i < 6; ++i)
+    queue.enqueue(i);
+  EXPECT_EQ(allocated, 0);
+  queue.SetFront(1);
+  EXPECT_EQ(allocated, 0);
+  EXPECT_EQ(queue.GetFront(), 1);
+
+  queue.enqueue(6);
+  EXPECT_GT(allocated, 0);
+  for (int i = 2; i < 7; ++i)
+    EXPECT_EQ(queue.dequeue(), i);
+  queue.shrink_to_fit();
+  EXPECT_EQ(allocated, 0);
+}
+
+TEST(InlineTest, SmallQueueMoveKeepsOrder)
+{
+  TSmallQueue<string, 4> queue;
+  for (string s : { "a", "b", "c" })
+    queue.enqueue(s);
+  queue.dequeue();
+  queue.enqueue("d");
+  queue.enqueue("e");
+  TSmallQueue<string, 4> moved(std::move(queue));
+  EXPECT_TRUE(queue.IsEmpty());
+  stringstream out;
+  out << moved;
+  EXPECT_EQ(out.str(), "[b, c, d, e]");
+}
+
+constexpr int StaticBalance(const char* text)
+{
+  TStaticStack<char, 16> open;
+  for (; *text != '\0'; ++text)
+  {
+    if (*text == '(' || *text == '[')
+    {
+      if (!open.push(*text))
+        return -1;
+    }
+    else if (*text == ')' || *text == ']')
+    {
+      char c = 0;
+      if (!open.pop(c) || (c == '(') != (*text == ')'))
+        return 0;
+    }
+  }
+  return open.IsEmpty() ? 1 : 0;
+}
+
+constexpr int StaticQueueSum()
+{
+  TStaticQueue<int, 4> queue;
+  int sum = 0;
+  for (int i = 1; i <= 10; ++i)
+  {
+    if (queue.IsFull())
+    {
+      int element = 0;
+      queue.dequeue(element);
+      sum += element;
+    }
+    queue.enqueue(i);
+  }
+  for (int element : queue)
+    sum += element * 100;
+  return sum;
+}
+
+static_assert(StaticBalance("([()])[]") == 1);
+static_assert(StaticBalance("([)]") == 0);
+static_assert(StaticQueueSum() == 21 + 3400);
+static_assert(sizeof(TStaticQueue<int, 8>) == 8 * sizeof(int) + 2 * sizeof(size_t));
+
+TEST(TStaticStackTest, PushPopWithoutExceptions)
+{
+  TStaticStack<string, 2> stack;
+  EXPECT_EQ(stack.GetCapacity(), 2);
+  EXPECT_TRUE(stack.push("a"));
+  string b = "b";
+  EXPECT_TRUE(stack.push(std::move(b)));
+  EXPECT_FALSE(stack.push("c"));
+  EXPECT_TRUE(stack.IsFull());
+  EXPECT_EQ(stack.top(), "b");
+  stack.top() += "!";
+
+  stringstream out;
+  out << stack;
+  EXPECT_EQ(out.str(), "[a, b!]");
+
+  string element;
+  EXPECT_TRUE(stack.pop(element));
+  EXPECT_EQ(element, "b!");
+  EXPECT_TRUE(stack.pop(element));
+  EXPECT_FALSE(stack.pop(element));
+  EXPECT_EQ(element, "a");
+}
+
+TEST(TStaticQueueTest, RingWrapsWithoutExceptions)
+{
+  TStaticQueue<int, 4> queue;
+  int element = 0;
+  EXPECT_FALSE(queue.dequeue(element));
+  for (int i = 0; i < 4; ++i)
+    EXPECT_TRUE(queue.enqueue(i));
+  EXPECT_FALSE(queue.enqueue(4));
+  for (int round = 0; round < 10; ++round)
+  {
+    EXPECT_TRUE(queue.dequeue(element));
+    EXPECT_EQ(element, round);
+    EXPECT_TRUE(queue.enqueue(round + 4));
+  }
+  EXPECT_EQ(queue.front(), 10);
+  EXPECT_EQ(queue[3], 13);
+  EXPECT_EQ(queue.GetFront(), 2);
+
+  stringstream out;
+  out << queue;
+  EXPECT_EQ(out.str(), "[10, 11, 12, 13]");
+}
+
+struct TThrowOnCopy
+{
+  int value;
+  TThrowOnCopy(int value_) : value(value_) {}
+  TThrowOnCopy(const TThrowOnCopy& other) : value(other.value)
+  {
+    if (value < 0)
+      throw("Copy failed");
+  }
+  TThrowOnCopy(TThrowOnCopy&&) noexcept = default;
+  TThrowOnCopy& operator=(TThrowOnCopy&& other)
+  {
+    if (other.value < -100)
+      throw("Move failed");
+    value = other.value;
+    return *this;
+  }
+};
+
+static_assert(noexcept(declval<TStack<int>&>().try_pop()));
+static_assert(noexcept(declval<TQueue<int>&>().try_dequeue()));
+static_assert(noexcept(declval<const TQueue<int>&>().front()));
+
+TEST(TryTest, StackTryPushAndPop)
+{
+  TStack<int, allocator<int>, TGeometricGrowth, TOpStats> stack;
+  int element = 0;
+  EXPECT_FALSE(stack.try_pop(element));
+  EXPECT_FALSE(stack.try_pop().has_value());
+  EXPECT_EQ(stack.GetStats().GetEmptyPops(), 2u);
+
+  for (int i = 0; i < 5; ++i)
+    EXPECT_TRUE(stack.try_push(i));
+  EXPECT_EQ(stack.top(), 4);
+  stack.top() = 40;
+  EXPECT_TRUE(stack.try_pop(element));
+  EXPECT_EQ(element, 40);
+  EXPECT_EQ(stack.try_pop(), optional<int>(3));
+  EXPECT_EQ(stack.GetTop(), 3u);
+}
+
+TEST(TryTest, TryPushFailsWhenFullWithoutThrowing)
+{
+  TStack<int, std::allocator<int>, TNoGrowth> stack(2);
+  EXPECT_TRUE(stack.try_push(1));
+  EXPECT_TRUE(stack.try_push(2));
+  EXPECT_FALSE(stack.try_push(3));
+  EXPECT_EQ(stack.GetTop(), 2u);
+
+  TQueue<int, TModuloIndex, std::allocator<int>, TCappedGrowth> queue;
+  queue.SetGrowth(TCappedGrowth(4, 2));
+  for (int i = 0; i < 4; ++i)
+    EXPECT_TRUE(queue.try_enqueue(i));
+  EXPECT_FALSE(queue.try_enqueue(4));
+  EXPECT_EQ(queue.GetCount(), 4u);
+}
+
+TEST(TryTest, ElementExceptionsPropagate)
+{
+  TStack<TThrowOnCopy> stack;
+  TThrowOnCopy good(1), bad(-1);
+  EXPECT_TRUE(stack.try_push(good));
+  EXPECT_THROW(stack.try_push(bad), const char*);
+  EXPECT_TRUE(stack.try_push(TThrowOnCopy(-200)));
+  EXPECT_EQ(stack.GetTop(), 2u);
+
+  TThrowOnCopy element(0);
+  EXPECT_THROW(stack.try_pop(element), const char*);
+  EXPECT_EQ(stack.GetTop(), 2u);
+  EXPECT_EQ(stack.top().value, -200);
+}
+
+TEST(TryTest, QueueTryEnqueueAndDequeue)
+{
+  TQueue<string> queue(2);
+  string element;
+  EXPECT_FALSE(queue.try_dequeue(element));
+  EXPECT_EQ(queue.try_dequeue(), nullopt);
+
+  for (int round = 0; round < 6; ++round)
+  {
+    EXPECT_TRUE(queue.try_enqueue(to_string(2 * round)));
+    EXPECT_TRUE(queue.try_enqueue(to_string(2 * round + 1)));
+    EXPECT_EQ(queue.front(), to_string(round));
+    EXPECT_TRUE(queue.try_dequeue(element));
+    EXPECT_EQ(element, to_string(round));
+  }
+  queue.front() += "!";
+  EXPECT_EQ(queue.try_dequeue(), optional<string>("6!"));
+  EXPECT_EQ(queue.GetCount(), 5u);
+}
+
 TEST(IOStreamTest, StackOutput)
 {
   TStack<int> stack(3);
@@ -422,3 +1896,493 @@ TEST(EdgeCaseTest, QueueMultipleResize)
   for (int i = 0; i < 100; ++i)
     EXPECT_EQ(queue.dequeue(), i);
 }
+
+TEST(TSPSCQueueTest, CapacityRoundsToPowerOfTwo)
+{
+  TSPSCQueue<int> queue(5);
+  EXPECT_EQ(queue.GetCapacity(), 8);
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_THROW(TSPSCQueue<int>(0), const char*);
+}
+
+TEST(TSPSCQueueTest, EnqueueAndDequeue)
+{
+  TSPSCQueue<int> queue(2);
+  EXPECT_TRUE(queue.try_enqueue(1));
+  EXPECT_TRUE(queue.try_enqueue(2));
+  EXPECT_TRUE(queue.IsFull());
+  EXPECT_FALSE(queue.try_enqueue(3));
+
+  int element = 0;
+  EXPECT_TRUE(queue.try_dequeue(element));
+  EXPECT_EQ(element, 1);
+  EXPECT_TRUE(queue.try_enqueue(3));
+  EXPECT_TRUE(queue.try_dequeue(element));
+  EXPECT_EQ(element, 2);
+  EXPECT_TRUE(queue.try_dequeue(element));
+  EXPECT_EQ(element, 3);
+  EXPECT_FALSE(queue.try_dequeue(element));
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(TSPSCQueueTest, ProducerConsumer)
+{
+  const int n = 100000;
+  TSPSCQueue<int> queue(64);
+
+  thread producer([&]()
+  {
+    for (int i = 0; i < n; ++i)
+      while (!queue.try_enqueue(i))
+        this_thread::yield();
+  });
+
+  long long sum = 0;
+  bool ordered = true;
+  int expected = 0;
+  while (expected < n)
+  {
+    int element;
+    if (queue.try_dequeue(element))
+    {
+      ordered = ordered && element == expected;
+      sum += element;
+      expected++;
+    }
+    else
+      this_thread::yield();
+  }
+  producer.join();
+
+  EXPECT_TRUE(ordered);
+  EXPECT_EQ(sum, (long long)n * (n - 1) / 2);
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(TSPSCQueueTest, BlockingConsumerWakesUp)
+{
+  const int n = 20000;
+  TSPSCQueue<int> queue(16);
+  thread producer([&]()
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      if (i % 1000 == 0)
+        this_thread::sleep_for(chrono::milliseconds(1));
+      queue.enqueue(i);
+    }
+  });
+
+  bool ordered = true;
+  for (int i = 0; i < n; ++i)
+    ordered = ordered && queue.dequeue() == i;
+  producer.join();
+  EXPECT_TRUE(ordered);
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(TSPSCQueueTest, TryOperationsWakeBlockedSide)
+{
+  const int n = 1000;
+  TSPSCQueue<int> queue(4);
+  thread producer([&]()
+  {
+    for (int i = 0; i < n; ++i)
+      while (!queue.try_enqueue(i))
+        this_thread::yield();
+  });
+  bool ordered = true;
+  for (int i = 0; i < n; ++i)
+    ordered = ordered && queue.dequeue() == i;
+  producer.join();
+  EXPECT_TRUE(ordered);
+
+  thread consumer([&]()
+  {
+    int element;
+    for (int i = 0; i < n; ++i)
+    {
+      while (!queue.try_dequeue(element))
+        this_thread::yield();
+      ordered = ordered && element == i;
+    }
+  });
+  for (int i = 0; i < n; ++i)
+    queue.enqueue(i);
+  consumer.join();
+  EXPECT_TRUE(ordered);
+}
+
+TEST(TSPSCQueueTest, TimedOperationsExpire)
+{
+  TSPSCQueue<int> queue(2);
+  int element = 0;
+  auto start = chrono::steady_clock::now();
+  EXPECT_FALSE(queue.dequeue_for(element, chrono::milliseconds(20)));
+  EXPECT_GE(chrono::steady_clock::now() - start, chrono::milliseconds(20));
+
+  EXPECT_TRUE(queue.enqueue_for(1, chrono::milliseconds(20)));
+  EXPECT_TRUE(queue.enqueue_for(2, chrono::milliseconds(20)));
+  EXPECT_FALSE(queue.enqueue_for(3, chrono::milliseconds(20)));
+  EXPECT_TRUE(queue.dequeue_for(element, chrono::milliseconds(20)));
+  EXPECT_EQ(element, 1);
+}
+
+TEST(TMPMCQueueTest, EnqueueAndDequeue)
+{
+  TMPMCQueue<int> queue(3);
+  EXPECT_EQ(queue.GetCapacity(), 4);
+  for (int i = 0; i < 4; ++i)
+    EXPECT_TRUE(queue.try_enqueue(i));
+  EXPECT_TRUE(queue.IsFull());
+  EXPECT_FALSE(queue.try_enqueue(4));
+
+  int element = -1;
+  for (int i = 0; i < 4; ++i)
+  {
+    EXPECT_TRUE(queue.try_dequeue(element));
+    EXPECT_EQ(element, i);
+  }
+  EXPECT_FALSE(queue.try_dequeue(element));
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(TMPMCQueueTest, MultipleProducersAndConsumers)
+{
+  const int producers = 4;
+  const int consumers = 4;
+  const int perProducer = 20000;
+  TMPMCQueue<int> queue(128);
+  atomic<long long> sum(0);
+  atomic<int> received(0);
+
+  vector<thread> threads;
+  for (int p = 0; p < producers; ++p)
+    threads.emplace_back([&, p]()
+    {
+      for (int i = 0; i < perProducer; ++i)
+        while (!queue.try_enqueue(p * perProducer + i))
+          this_thread::yield();
+    });
+  for (int c = 0; c < consumers; ++c)
+    threads.emplace_back([&]()
+    {
+      int element;
+      while (received.load() < producers * perProducer)
+      {
+        if (queue.try_dequeue(element))
+        {
+          sum += element;
+          received++;
+        }
+        else
+          this_thread::yield();
+      }
+    });
+  for (auto& t : threads)
+    t.join();
+
+  const long long n = producers * perProducer;
+  EXPECT_EQ(received.load(), n);
+  EXPECT_EQ(sum.load(), n * (n - 1) / 2);
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(TMPMCQueueTest, BlockingProducersAndConsumers)
+{
+  const int producers = 3;
+  const int consumers = 3;
+  const int perProducer = 10000;
+  TMPMCQueue<int> queue(8);
+  atomic<long long> sum(0);
+
+  vector<thread> threads;
+  for (int p = 0; p < producers; ++p)
+    threads.emplace_back([&, p]()
+    {
+      for (int i = 0; i < perProducer; ++i)
+        queue.enqueue(p * perProducer + i);
+    });
+  for (int c = 0; c < consumers; ++c)
+    threads.emplace_back([&]()
+    {
+      for (int i = 0; i < perProducer; ++i)
+        sum += queue.dequeue();
+    });
+  for (auto& t : threads)
+    t.join();
+
+  const long long n = producers * perProducer;
+  EXPECT_EQ(sum.load(), n * (n - 1) / 2);
+  int element;
+  EXPECT_FALSE(queue.dequeue_for(element, chrono::milliseconds(1)));
+}
+
+TEST(TMPMCQueueTest, TryProducersWakeBlockingConsumers)
+{
+  const int producers = 2;
+  const int consumers = 2;
+  const int perProducer = 2000;
+  TMPMCQueue<int> queue(4);
+  atomic<long long> sum(0);
+
+  vector<thread> threads;
+  for (int p = 0; p < producers; ++p)
+    threads.emplace_back([&, p]()
+    {
+      for (int i = 0; i < perProducer; ++i)
+        while (!queue.try_enqueue(p * perProducer + i))
+          this_thread::yield();
+    });
+  for (int c = 0; c < consumers; ++c)
+    threads.emplace_back([&]()
+    {
+      for (int i = 0; i < perProducer; ++i)
+        sum += queue.dequeue();
+    });
+  for (auto& t : threads)
+    t.join();
+
+  const long long n = producers * perProducer;
+  EXPECT_EQ(sum.load(), n * (n - 1) / 2);
+}
+
+TEST(TWorkStealingDequeTest, OwnerLifoThiefFifo)
+{
+  TWorkStealingDeque<int> deque(2);
+  for (int i = 0; i < 10; ++i)
+    deque.push(i);
+  EXPECT_EQ(deque.Size(), 10);
+  EXPECT_GE(deque.GetCapacity(), 10);
+
+  int element = -1;
+  EXPECT_TRUE(deque.pop(element));
+  EXPECT_EQ(element, 9);
+  EXPECT_TRUE(deque.steal(element));
+  EXPECT_EQ(element, 0);
+  EXPECT_TRUE(deque.steal(element));
+  EXPECT_EQ(element, 1);
+  for (int i = 8; i >= 2; --i)
+  {
+    EXPECT_TRUE(deque.pop(element));
+    EXPECT_EQ(element, i);
+  }
+  EXPECT_FALSE(deque.pop(element));
+  EXPECT_FALSE(deque.steal(element));
+  EXPECT_TRUE(deque.IsEmpty());
+  EXPECT_THROW(TWorkStealingDeque<int>(0), const char*);
+}
+
+TEST(TWorkStealingDequeTest, EveryItemTakenOnce)
+{
+  const int n = 100000;
+  const int thieves = 3;
+  TWorkStealingDeque<int> deque(4);
+  vector<atomic<int>> taken(n);
+  atomic<bool> done(false);
+
+  vector<thread> threads;
+  for (int i = 0; i < thieves; ++i)
+    threads.emplace_back([&]()
+    {
+      int element;
+      while (!done.load())
+      {
+        if (deque.steal(element))
+          taken[element]++;
+        else
+          this_thread::yield();
+      }
+    });
+
+  int element;
+  for (int i = 0; i < n; ++i)
+  {
+    deque.push(i);
+    if (i % 3 == 0 && deque.pop(element))
+      taken[element]++;
+  }
+  while (deque.pop(element))
+    taken[element]++;
+  while (!deque.IsEmpty())
+    this_thread::yield();
+  done = true;
+  for (auto& t : threads)
+    t.join();
+
+  int once = 0;
+  for (int i = 0; i < n; ++i)
+    once += taken[i].load() == 1;
+  EXPECT_EQ(once, n);
+}
+
+TEST(TConcurrentStackTest, PushAndPop)
+{
+  TConcurrentStack<int> stack(3);
+  EXPECT_TRUE(stack.IsEmpty());
+  EXPECT_TRUE(stack.push(10));
+  EXPECT_TRUE(stack.push(20));
+  EXPECT_TRUE(stack.push(30));
+  EXPECT_FALSE(stack.push(40));
+
+  int element = 0;
+  EXPECT_TRUE(stack.pop(element));
+  EXPECT_EQ(element, 30);
+  EXPECT_TRUE(stack.pop(element));
+  EXPECT_EQ(element, 20);
+  EXPECT_TRUE(stack.push(50));
+  EXPECT_TRUE(stack.pop(element));
+  EXPECT_EQ(element, 50);
+  EXPECT_TRUE(stack.pop(element));
+  EXPECT_EQ(element, 10);
+  EXPECT_FALSE(stack.pop(element));
+  EXPECT_TRUE(stack.IsEmpty());
+  EXPECT_THROW(TConcurrentStack<int>(0), const char*);
+}
+
+TEST(TConcurrentStackTest, ConcurrentFreeList)
+{
+  const int threadsCount = 4;
+  const int rounds = 20000;
+  TConcurrentStack<int> stack(16);
+  for (int i = 0; i < 16; ++i)
+    stack.push(i);
+
+  vector<thread> threads;
+  for (int t = 0; t < threadsCount; ++t)
+    threads.emplace_back([&]()
+    {
+      for (int i = 0; i < rounds; ++i)
+      {
+        int element;
+        if (stack.pop(element))
+          while (!stack.push(element))
+            this_thread::yield();
+      }
+    });
+  for (auto& t : threads)
+    t.join();
+
+  bool seen[16] = {};
+  int element;
+  int count = 0;
+  while (stack.pop(element))
+  {
+    ASSERT_TRUE(element >= 0 && element < 16);
+    EXPECT_FALSE(seen[element]);
+    seen[element] = true;
+    count++;
+  }
+  EXPECT_EQ(count, 16);
+}
+
+TEST(TEliminationStackTest, PushAndPop)
+{
+  TEliminationStack<int> stack(2, 4, 16);
+  EXPECT_EQ(stack.GetWidth(), 4);
+  EXPECT_EQ(stack.GetBackoff(), 16);
+  EXPECT_TRUE(stack.push(1));
+  EXPECT_TRUE(stack.push(2));
+  EXPECT_FALSE(stack.push(3));
+
+  int element = 0;
+  EXPECT_TRUE(stack.pop(element));
+  EXPECT_EQ(element, 2);
+  EXPECT_TRUE(stack.pop(element));
+  EXPECT_EQ(element, 1);
+  EXPECT_FALSE(stack.pop(element));
+  EXPECT_THROW(TEliminationStack<int>(2, 0), const char*);
+}
+
+struct TEliminationProbe : TEliminationStack<int>
+{
+  TEliminationProbe() : TEliminationStack<int>(2, 1, 0) {}
+
+  uint32_t Offer(int element)
+  {
+    uint32_t index = AcquireNode();
+    memory[index].data = element;
+    EXPECT_TRUE(OfferNode(slots[0], index));
+    return index;
+  }
+
+  bool Settle(uint32_t index)
+  {
+    return SettleNode(slots[0], index);
+  }
+
+  bool Take(int& element)
+  {
+    return EliminatePop(element, 1);
+  }
+};
+
+TEST(TEliminationStackTest, ExchangeBypassesSharedLists)
+{
+  static_assert(!is_convertible_v<TEliminationStack<int>*, TConcurrentStack<int>*>);
+  TEliminationProbe stack;
+  int element = 0;
+  uint32_t index = stack.Offer(42);
+  EXPECT_TRUE(stack.Take(element));
+  EXPECT_TRUE(stack.Settle(index));
+  EXPECT_EQ(element, 42);
+  EXPECT_EQ(stack.GetEliminations(), 1);
+  EXPECT_TRUE(stack.IsEmpty());
+
+  EXPECT_EQ(stack.GetCapacity(), 2);
+  EXPECT_TRUE(stack.push(1));
+  EXPECT_TRUE(stack.push(2));
+  EXPECT_FALSE(stack.push(3));
+  EXPECT_TRUE(stack.pop(element));
+  EXPECT_EQ(element, 2);
+}
+
+TEST(TEliminationStackTest, UnmatchedOfferIsWithdrawn)
+{
+  TEliminationProbe stack;
+  int element = 0;
+  uint32_t index = stack.Offer(7);
+  EXPECT_FALSE(stack.Settle(index));
+  EXPECT_FALSE(stack.Take(element));
+  EXPECT_EQ(element, 0);
+  EXPECT_EQ(stack.GetEliminations(), 0);
+}
+
+TEST(TEliminationStackTest, SymmetricLoadPreservesElements)
+{
+  const int threadsCount = 8;
+  const int perThread = 5000;
+  TEliminationStack<int> stack(threadsCount * perThread, 4, 64);
+  atomic<long long> popped(0);
+  atomic<int> poppedCount(0);
+
+  vector<thread> threads;
+  for (int t = 0; t < threadsCount; ++t)
+    threads.emplace_back([&, t]()
+    {
+      for (int i = 0; i < perThread; ++i)
+      {
+        stack.push(t * perThread + i);
+        int element;
+        if (stack.pop(element))
+        {
+          popped += element;
+          poppedCount++;
+        }
+      }
+    });
+  for (auto& t : threads)
+    t.join();
+
+  long long rest = 0;
+  int element;
+  while (stack.pop(element))
+  {
+    rest += element;
+    poppedCount++;
+  }
+
+  const long long n = threadsCount * perThread;
+  EXPECT_EQ(poppedCount.load(), n);
+  EXPECT_EQ(popped.load() + rest, n * (n - 1) / 2);
+}